@@ -36,10 +36,14 @@
 
 #include "core/config/project_settings.h"
 #include "core/error/error_list.h"
+#include "core/io/dir_access.h"
 #include "core/object/object.h"
+#include "core/object/worker_thread_pool.h"
+#include "core/os/os.h"
 #include "core/templates/vector.h"
 #include "editor/editor_file_system.h"
 #include "editor/editor_node.h"
+#include "editor/editor_settings.h"
 #include "editor/gui/editor_file_dialog.h"
 #include "scene/3d/mesh_instance_3d.h"
 #include "scene/gui/check_box.h"
@@ -54,36 +58,122 @@ bool MaterialXPlugin::has_main_screen() const {
 }
 
 MaterialXPlugin::MaterialXPlugin() {
+	EDITOR_DEF("filesystem/import/materialx/use_sub_threads", true);
+
 	file_export_lib = memnew(EditorFileDialog);
 	EditorNode::get_singleton()->get_gui_base()->add_child(file_export_lib);
-	file_export_lib->connect("file_selected", callable_mp(this, &MaterialXPlugin::save_materialx_as_resource));
+	file_export_lib->connect("files_selected", callable_mp(this, &MaterialXPlugin::save_materialx_as_resources));
 	file_export_lib->set_title(TTR("Import MaterialX Material"));
-	file_export_lib->set_file_mode(EditorFileDialog::FILE_MODE_OPEN_FILE);
+	file_export_lib->set_file_mode(EditorFileDialog::FILE_MODE_OPEN_FILES);
 	file_export_lib->set_access(EditorFileDialog::ACCESS_FILESYSTEM);
 	file_export_lib->clear_filters();
 	file_export_lib->add_filter("*.mtlx");
 	file_export_lib->set_title(TTR("Import MaterialX to Material resource"));
 
+	dir_export_lib = memnew(EditorFileDialog);
+	EditorNode::get_singleton()->get_gui_base()->add_child(dir_export_lib);
+	dir_export_lib->connect("dir_selected", callable_mp(this, &MaterialXPlugin::save_materialx_dir_as_resources));
+	dir_export_lib->set_file_mode(EditorFileDialog::FILE_MODE_OPEN_DIR);
+	dir_export_lib->set_access(EditorFileDialog::ACCESS_FILESYSTEM);
+	dir_export_lib->set_title(TTR("Import MaterialX directory to Material resources"));
+
 	add_tool_menu_item(TTR("Import MaterialX Material ..."), callable_mp(this, &MaterialXPlugin::_material_x_dialog_action));
+	add_tool_menu_item(TTR("Import MaterialX Directory ..."), callable_mp(this, &MaterialXPlugin::_material_x_dir_dialog_action));
+}
+
+void MaterialXPlugin::_import_batch_item(uint32_t p_index, BatchImport *p_batch) {
+	String error;
+	p_batch->resources[p_index] = p_batch->loader->load_material(p_batch->files[p_index], &error, p_batch->use_sub_threads);
+	if (p_batch->resources[p_index].is_null()) {
+		p_batch->errors[p_index] = error.is_empty() ? String("Material import error") : error;
+	}
+	p_batch->completed.increment();
 }
 
-void MaterialXPlugin::save_materialx_as_resource(String p_file) {
-	Ref<MTLXLoader> loader;
-	loader.instantiate();
-	String dir = p_file.get_base_dir();
-	String filename = p_file.get_file().get_basename();
-	String resource_path = dir.path_join(filename + ".res");
-	Ref<Material> resource = loader->_load(resource_path, p_file, true, 0);
-	if (resource.is_null()) {
-		ERR_PRINT("Material save error");
+void MaterialXPlugin::_find_materialx_files(const String &p_dir, Vector<String> &r_files) {
+	for (const String &file : DirAccess::get_files_at(p_dir)) {
+		if (file.get_extension().to_lower() == "mtlx") {
+			r_files.push_back(p_dir.path_join(file));
+		}
+	}
+	for (const String &dir : DirAccess::get_directories_at(p_dir)) {
+		_find_materialx_files(p_dir.path_join(dir), r_files);
+	}
+}
+
+void MaterialXPlugin::save_materialx_dir_as_resources(const String &p_dir) {
+	Vector<String> files;
+	_find_materialx_files(p_dir, files);
+	if (files.is_empty()) {
+		EditorNode::get_singleton()->show_warning(vformat(TTR("No MaterialX files found in %s."), p_dir));
 		return;
 	}
-	ResourceSaver::save(resource, resource_path);
+	save_materialx_as_resources(files);
+}
+
+void MaterialXPlugin::save_materialx_as_resources(const Vector<String> &p_files) {
+	// Files are spread over the worker pool when there are several of them,
+	// and a single file may use the pool to parse its libraries instead, so
+	// the pool is never asked for threads from inside its own tasks.
+	const bool use_sub_threads = EDITOR_GET("filesystem/import/materialx/use_sub_threads");
+	const bool parallel = use_sub_threads && p_files.size() > 1;
+
+	BatchImport batch;
+	batch.use_sub_threads = use_sub_threads && !parallel;
+	batch.loader.instantiate();
+	batch.files = p_files;
+	batch.resources.resize(p_files.size());
+	batch.errors.resize(p_files.size());
+
+	// Parsing, validation and conversion run on the worker pool; saving and
+	// the filesystem scan stay on this thread and happen once for the batch.
+	{
+		EditorProgress progress("import_materialx", TTR("Importing MaterialX"), p_files.size());
+		if (parallel) {
+			WorkerThreadPool::GroupID group_task = WorkerThreadPool::get_singleton()->add_template_group_task(this, &MaterialXPlugin::_import_batch_item, &batch, p_files.size(), -1, true, SNAME("MaterialXImport"));
+			while (!WorkerThreadPool::get_singleton()->is_group_task_completed(group_task)) {
+				uint32_t completed = batch.completed.get();
+				progress.step(vformat(TTR("Importing %d of %d"), completed, p_files.size()), completed, true);
+				OS::get_singleton()->delay_usec(10000);
+			}
+			WorkerThreadPool::get_singleton()->wait_for_group_task_completion(group_task);
+		} else {
+			for (int i = 0; i < p_files.size(); i++) {
+				progress.step(p_files[i].get_file(), i);
+				_import_batch_item(i, &batch);
+			}
+		}
+	}
+
+	String error_text;
+	int imported = 0;
+	for (int i = 0; i < p_files.size(); i++) {
+		if (batch.resources[i].is_null()) {
+			error_text += p_files[i] + ": " + batch.errors[i] + "\n";
+			continue;
+		}
+		String resource_path = p_files[i].get_base_dir().path_join(p_files[i].get_file().get_basename() + ".res");
+		Error err = ResourceSaver::save(batch.resources[i], resource_path);
+		if (err != OK) {
+			error_text += p_files[i] + ": " + vformat(TTR("Can't save resource to %s."), resource_path) + "\n";
+			continue;
+		}
+		imported++;
+	}
 	EditorFileSystem::get_singleton()->scan_changes();
+
+	if (!error_text.is_empty()) {
+		ERR_PRINT(vformat("MaterialX imported %d of %d files.", imported, p_files.size()));
+		EditorNode::get_singleton()->show_warning(vformat(TTR("Imported %d of %d MaterialX files. Errors:\n%s"), imported, p_files.size(), error_text));
+	}
 }
 
 void MaterialXPlugin::_material_x_dialog_action() {
 	file_export_lib->popup_centered_ratio();
 }
 
+void MaterialXPlugin::_material_x_dir_dialog_action() {
+	dir_export_lib->popup_centered_ratio();
+}
+
 #endif // TOOLS_ENABLED
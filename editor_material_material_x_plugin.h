@@ -35,15 +35,31 @@
 
 #include "material_x_3d.h"
 
+#include "core/templates/local_vector.h"
+#include "core/templates/safe_refcount.h"
 #include "editor/editor_plugin.h"
 #include "editor/gui/editor_file_dialog.h"
 
 class MaterialXPlugin : public EditorPlugin {
 	GDCLASS(MaterialXPlugin, EditorPlugin);
 
+	struct BatchImport {
+		Ref<MTLXLoader> loader;
+		Vector<String> files;
+		LocalVector<Ref<Resource>> resources;
+		LocalVector<String> errors;
+		SafeNumeric<uint32_t> completed;
+		bool use_sub_threads = false;
+	};
+
 	EditorFileDialog *file_export_lib = nullptr;
+	EditorFileDialog *dir_export_lib = nullptr;
 	void _material_x_dialog_action();
-	void save_materialx_as_resource(String p_file);
+	void _material_x_dir_dialog_action();
+	void _import_batch_item(uint32_t p_index, BatchImport *p_batch);
+	static void _find_materialx_files(const String &p_dir, Vector<String> &r_files);
+	void save_materialx_dir_as_resources(const String &p_dir);
+	void save_materialx_as_resources(const Vector<String> &p_files);
 
 public:
 	virtual String get_name() const override;
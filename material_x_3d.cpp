@@ -30,19 +30,193 @@
 
 #include "material_x_3d.h"
 
+#include "material_x_shader_translator.h"
+
 #include "core/config/project_settings.h"
 #include "core/io/config_file.h"
 #include "core/io/dir_access.h"
+#include "core/io/file_access.h"
+#include "core/io/image.h"
+#include "core/io/resource_loader.h"
+#include "core/io/resource_saver.h"
 #include "core/variant/variant.h"
 #include "modules/tinyexr/image_loader_tinyexr.h"
 #include "scene/resources/image_texture.h"
 #include "scene/resources/material.h"
+#include "scene/resources/shader.h"
 #include "scene/resources/visual_shader.h"
 #include "thirdparty/mtlx/source/MaterialXCore/Node.h"
 #include "thirdparty/mtlx/source/MaterialXCore/Traversal.h"
+#include "thirdparty/mtlx/source/MaterialXGenShader/HwShaderGenerator.h"
+#include "thirdparty/mtlx/source/MaterialXGenShader/Util.h"
+
+Mutex MTLXLoader::library_signature_mutex;
+HashMap<String, String> MTLXLoader::library_signatures;
+Mutex MTLXLoader::library_cache_mutex;
+HashMap<String, MTLXLoader::LibraryCacheEntry> MTLXLoader::library_cache;
+mx::FileSystemCachePtr MTLXLoader::file_system_cache = mx::FileSystemCache::create();
+Mutex MTLXLoader::shader_cache_mutex;
+mx::ShaderCachePtr MTLXLoader::shader_cache = mx::ShaderCache::create();
+HashMap<uint64_t, MTLXLoader::ShaderResourceEntry> MTLXLoader::shader_resources;
+HashMap<String, MTLXLoader::GenContextCoreEntry> MTLXLoader::gen_context_cores;
+
+String MTLXLoader::compute_library_signature(const mx::FilePath &p_folder) {
+	// Mirror the traversal of mx::loadLibraries. The listings come from the
+	// file system cache, but the modification times are read afresh, and a
+	// directory's time changes whenever an entry is added to or removed from
+	// it, so a stale listing always shows up as a changed signature.
+	// A folder that is missing or holds no documents has an empty signature,
+	// as there is no library to load from it.
+	if (!p_folder.isDirectory()) {
+		return String();
+	}
+	String signature = itos(FileAccess::get_modified_time(String(p_folder.asString().c_str()))) + ";";
+	bool has_documents = false;
+	for (const mx::FilePath &dir : file_system_cache->getSubDirectories(p_folder)) {
+		signature += String(dir.asString().c_str()) + ":" + itos(FileAccess::get_modified_time(String(dir.asString().c_str()))) + ";";
+		for (const mx::FilePath &file : file_system_cache->getFilesInDirectory(dir, mx::MTLX_EXTENSION)) {
+			String file_path = String((dir / file).asString().c_str());
+			signature += file_path + ":" + itos(FileAccess::get_modified_time(file_path)) + ";";
+			has_documents = true;
+		}
+	}
+	return has_documents ? signature : String();
+}
+
+String MTLXLoader::get_library_signature(const mx::FilePath &p_folder) {
+	String key = String(p_folder.asString().c_str());
+	String signature = compute_library_signature(p_folder);
+	{
+		MutexLock lock(library_signature_mutex);
+		const String *known = library_signatures.getptr(key);
+		if (known && *known == signature) {
+			return signature;
+		}
+	}
+
+	// The folder is new or has changed on disk, so forget what is known about
+	// its contents and list them again.
+	file_system_cache->invalidate(p_folder);
+	signature = compute_library_signature(p_folder);
+	MutexLock lock(library_signature_mutex);
+	library_signatures[key] = signature;
+	return signature;
+}
+
+mx::ConstDocumentPtr MTLXLoader::get_data_library(const mx::FilePathVec &p_library_folders, const mx::FileSearchPath &p_search_path, bool p_use_sub_threads) {
+	// Each folder is cached on its own and chained to the folders after it,
+	// so earlier folders take precedence as they would with importLibrary,
+	// and folders shared between materials are only parsed once.
+	mx::ConstDocumentPtr data_library;
+	String key;
+	for (int i = int(p_library_folders.size()) - 1; i >= 0; i--) {
+		const mx::FilePath &folder = p_library_folders[i];
+		key = String(folder.asString().c_str()) + "|" + key;
+		String signature = get_library_signature(folder);
+		if (signature.is_empty()) {
+			continue;
+		}
+		// The next library in the chain is kept alive by the cached entry, so
+		// its address identifies it for as long as this entry can match.
+		signature += String::num_uint64(uint64_t(data_library.get()));
+
+		std::promise<mx::ConstDocumentPtr> promise;
+		std::shared_future<mx::ConstDocumentPtr> library;
+		bool owner = false;
+		{
+			MutexLock lock(library_cache_mutex);
+			LibraryCacheEntry *entry = library_cache.getptr(key);
+			if (entry && entry->signature == signature) {
+				library = entry->library;
+			} else {
+				if (entry) {
+					// The folder has changed on disk, so forget the node
+					// implementations created from its previous contents.
+					// A folder seen for the first time has none yet.
+					evict_gen_context_cores(folder);
+				}
+				library = promise.get_future().share();
+				library_cache[key] = LibraryCacheEntry{ signature, library };
+				owner = true;
+			}
+		}
+
+		if (owner) {
+			try {
+				mx::DocumentPtr document = mx::createDocument();
+				document->setDataLibrary(data_library);
+				mx::loadLibraries({ folder }, p_search_path, document, mx::StringSet(), nullptr, p_use_sub_threads ? 0 : 1);
+				// Every material document references these elements rather
+				// than a copy of them, so an edit would leak into all of them.
+				// Materials that need to change a definition take a local copy
+				// with materializeDataLibraryElement instead.
+				document->setReadOnly(true);
+				promise.set_value(document);
+			} catch (...) {
+				// Hand the error to the threads already waiting, and let the
+				// next call try again.
+				promise.set_exception(std::current_exception());
+				MutexLock lock(library_cache_mutex);
+				LibraryCacheEntry *entry = library_cache.getptr(key);
+				if (entry && entry->signature == signature) {
+					library_cache.erase(key);
+				}
+			}
+		}
+		data_library = library.get();
+	}
+	return data_library;
+}
+
+void MTLXLoader::evict_gen_context_cores(const mx::FilePath &p_folder) {
+	const String folder = String(p_folder.asString().c_str());
+	MutexLock lock(shader_cache_mutex);
+	Vector<String> evicted;
+	for (const KeyValue<String, GenContextCoreEntry> &E : gen_context_cores) {
+		if (E.value.folders.has(folder)) {
+			evicted.push_back(E.key);
+		}
+	}
+	for (const String &key : evicted) {
+		gen_context_cores.erase(key);
+	}
+}
+
+void MTLXLoader::clear_shader_cache() {
+	MutexLock lock(shader_cache_mutex);
+	shader_cache->clear();
+	shader_resources.clear();
+	gen_context_cores.clear();
+}
+
+void MTLXLoader::clear_library_cache() {
+	MutexLock lock(library_cache_mutex);
+	library_cache.clear();
+	{
+		MutexLock signature_lock(library_signature_mutex);
+		library_signatures.clear();
+	}
+	file_system_cache->clear();
+	clear_shader_cache();
+}
+
+void MTLXLoader::set_conversion_mode(ConversionMode p_mode) {
+	conversion_mode = p_mode;
+}
+
+MTLXLoader::ConversionMode MTLXLoader::get_conversion_mode() const {
+	return conversion_mode;
+}
 
 void MTLXLoader::_bind_methods() {
 	ClassDB::bind_method(D_METHOD("_load", "path", "original_path", "use_sub_threads", "cache_mode"), &MTLXLoader::_load);
+	ClassDB::bind_method(D_METHOD("set_conversion_mode", "mode"), &MTLXLoader::set_conversion_mode);
+	ClassDB::bind_method(D_METHOD("get_conversion_mode"), &MTLXLoader::get_conversion_mode);
+
+	ADD_PROPERTY(PropertyInfo(Variant::INT, "conversion_mode", PROPERTY_HINT_ENUM, "Shader Code,Visual Shader"), "set_conversion_mode", "get_conversion_mode");
+
+	BIND_ENUM_CONSTANT(CONVERSION_MODE_SHADER_CODE);
+	BIND_ENUM_CONSTANT(CONVERSION_MODE_VISUAL_SHADER);
 }
 
 Variant MTLXLoader::get_value_as_variant(const mx::ValuePtr &value) {
@@ -71,21 +245,146 @@ Variant MTLXLoader::get_value_as_variant(const mx::ValuePtr &value) {
 			mx::Vector4 vector_4 = value->asA<mx::Vector4>();
 			variant_value = Color(vector_4[0], vector_4[1], vector_4[2], vector_4[3]);
 		} else if (typeString == "matrix33") {
-			// Matrix33 m = value->asA<Matrix33>();
-			// TODO: fire 2022-03-11 add basis
+			// MaterialX matrices are uploaded row by row, so each row becomes a
+			// column of the GLSL matrix.
+			mx::Matrix33 matrix = value->asA<mx::Matrix33>();
+			Basis basis;
+			for (int i = 0; i < 3; i++) {
+				basis.set_column(i, Vector3(matrix[i][0], matrix[i][1], matrix[i][2]));
+			}
+			variant_value = basis;
 		} else if (typeString == "matrix44") {
-			// Matrix44 m = value->asA<Matrix44>();
-			// TODO: fire 2022-03-11 add transform
+			mx::Matrix44 matrix = value->asA<mx::Matrix44>();
+			Projection projection;
+			for (int i = 0; i < 4; i++) {
+				projection.columns[i] = Vector4(matrix[i][0], matrix[i][1], matrix[i][2], matrix[i][3]);
+			}
+			variant_value = projection;
 		}
 	}
 	return variant_value;
 }
 
+void MTLXLoader::report_error(String *r_error, const String &p_message) {
+	ERR_PRINT(p_message);
+	if (r_error) {
+		*r_error = p_message;
+	}
+}
+
 Variant MTLXLoader::_load(const String &p_save_path, const String &p_original_path, bool p_use_sub_threads, int64_t p_cache_mode) const {
-	// Globalize paths
-	String save_path = ProjectSettings::get_singleton()->globalize_path(p_save_path);
-	String original_path = ProjectSettings::get_singleton()->globalize_path(p_original_path);
+	return load_material(p_original_path, nullptr, p_use_sub_threads);
+}
+
+mx::FilePathVec MTLXLoader::get_library_folders(const String &p_original_path) {
+	mx::FilePathVec library_folders;
+	library_folders.push_back(ProjectSettings::get_singleton()->globalize_path(p_original_path.get_base_dir()).utf8().get_data());
+	library_folders.push_back(ProjectSettings::get_singleton()->globalize_path("res://libraries").utf8().get_data());
+	library_folders.push_back(ProjectSettings::get_singleton()->globalize_path("user://libraries").utf8().get_data());
+	return library_folders;
+}
+
+String MTLXLoader::get_cache_path(const String &p_original_path) {
+	return ProjectSettings::get_singleton()->get_imported_files_path().path_join(p_original_path.get_file() + "-" + p_original_path.md5_text());
+}
+
+String MTLXLoader::get_cache_hash(const String &p_original_path, const Vector<String> &p_dependencies) const {
+	// Everything the conversion reads: the document, the files it includes,
+	// the textures it binds and the libraries it is resolved against.
+	String hash_source = itos(CACHE_FORMAT_VERSION) + ";" + itos(conversion_mode) + ";" + FileAccess::get_md5(p_original_path) + ";";
+	// The generator: its version and the options set_gen_options gives it,
+	// so an update of either is not served from materials converted before.
+	hash_source += String(mx::getVersionString().c_str()) + ";";
+	for (bool transparent : { false, true }) {
+		mx::GenOptions options;
+		set_gen_options(options, transparent);
+		hash_source += String(mx::getOptionsSignature(options).c_str()) + ";";
+	}
+	for (const String &dependency : p_dependencies) {
+		hash_source += dependency + ":" + FileAccess::get_md5(dependency) + ";";
+	}
+	for (const mx::FilePath &folder : get_library_folders(p_original_path)) {
+		hash_source += get_library_signature(folder);
+	}
+	return hash_source.md5_text();
+}
+
+Ref<Resource> MTLXLoader::load_cached_material(const String &p_original_path) const {
+	const String cache_path = get_cache_path(p_original_path);
+	Ref<ConfigFile> cache_info;
+	cache_info.instantiate();
+	if (cache_info->load(cache_path + ".cache") != OK) {
+		return Ref<Resource>();
+	}
+	Vector<String> dependencies = cache_info->get_value("cache", "dependencies", Vector<String>());
+	if (String(cache_info->get_value("cache", "hash", String())) != get_cache_hash(p_original_path, dependencies)) {
+		return Ref<Resource>();
+	}
+	// The material itself is loaded afresh, since its file is rewritten in
+	// place whenever the conversion runs again. Its generated shader is an
+	// external resource named after its code, so it is taken from the
+	// resource cache instead, and cached materials sharing it share one
+	// instance and one compile.
+	Ref<Resource> material = ResourceLoader::load(cache_path + ".res", "", ResourceFormatLoader::CACHE_MODE_IGNORE);
+	Ref<ShaderMaterial> shader_material = material;
+	if (shader_material.is_valid() && shader_material->get_shader().is_valid()) {
+		const String shader_path = shader_material->get_shader()->get_path();
+		if (shader_path.begins_with(ProjectSettings::get_singleton()->get_imported_files_path().path_join("materialx-shader-"))) {
+			Ref<Shader> shader = ResourceLoader::load(shader_path, "", ResourceFormatLoader::CACHE_MODE_REUSE);
+			if (shader.is_valid()) {
+				shader_material->set_shader(shader);
+			}
+		}
+	}
+	return material;
+}
+
+void MTLXLoader::save_cached_material(const String &p_original_path, const Ref<Resource> &p_material, const Vector<String> &p_dependencies) const {
+	const String cache_path = get_cache_path(p_original_path);
 
+	// Save a generated shader on its own, named after its code, so that the
+	// cached materials sharing it reference one Shader resource, which is
+	// loaded and compiled once, instead of each embedding a copy.
+	Ref<ShaderMaterial> shader_material = p_material;
+	Ref<Shader> shader = shader_material.is_valid() ? shader_material->get_shader() : Ref<Shader>();
+	if (shader.is_valid() && !Object::cast_to<VisualShader>(shader.ptr())) {
+		MutexLock lock(shader_cache_mutex);
+		const String shader_path = ProjectSettings::get_singleton()->get_imported_files_path().path_join("materialx-shader-" + shader->get_code().md5_text() + ".res");
+		if (shader->get_path() != shader_path) {
+			if (!FileAccess::exists(shader_path) && ResourceSaver::save(shader, shader_path) != OK) {
+				WARN_PRINT(String("Can't cache the generated MaterialX shader: ") + shader_path);
+				return;
+			}
+			shader->set_path(shader_path, true);
+		}
+	}
+
+	if (ResourceSaver::save(p_material, cache_path + ".res") != OK) {
+		WARN_PRINT(String("Can't cache the converted MaterialX material: ") + cache_path + ".res");
+		return;
+	}
+	Ref<ConfigFile> cache_info;
+	cache_info.instantiate();
+	cache_info->set_value("cache", "hash", get_cache_hash(p_original_path, p_dependencies));
+	cache_info->set_value("cache", "dependencies", p_dependencies);
+	cache_info->save(cache_path + ".cache");
+}
+
+Ref<Resource> MTLXLoader::load_material(const String &p_original_path, String *r_error, bool p_use_sub_threads) const {
+	Ref<Resource> material = load_cached_material(p_original_path);
+	if (material.is_valid()) {
+		return material;
+	}
+
+	Vector<String> dependencies;
+	material = convert_material(p_original_path, dependencies, r_error, p_use_sub_threads);
+	if (material.is_valid()) {
+		save_cached_material(p_original_path, material, dependencies);
+	}
+	return material;
+}
+
+Ref<Resource> MTLXLoader::convert_material(const String &p_original_path, Vector<String> &r_dependencies, String *r_error, bool p_use_sub_threads) const {
 	// Create MaterialX document
 	mx::DocumentPtr doc = mx::createDocument();
 
@@ -94,7 +393,7 @@ Variant MTLXLoader::_load(const String &p_save_path, const String &p_original_pa
 		std::vector<MaterialPtr> materials;
 		mx::DocumentPtr dependLib = mx::createDocument();
 		mx::StringSet skipLibraryFiles;
-		mx::DocumentPtr stdLib;
+		mx::ConstDocumentPtr stdLib;
 		mx::StringSet xincludeFiles;
 
 		mx::StringVec distanceUnitOptions;
@@ -103,17 +402,16 @@ Variant MTLXLoader::_load(const String &p_save_path, const String &p_original_pa
 		mx::UnitConverterRegistryPtr unitRegistry =
 				mx::UnitConverterRegistry::create();
 		mx::FileSearchPath searchPath(ProjectSettings::get_singleton()->globalize_path(p_original_path.get_base_dir()).utf8().get_data());
+		// The material's folder is the first library folder, so its listings
+		// are checked against the disk by get_data_library below.
+		searchPath.setFileSystemCache(file_system_cache);
+		mx::FilePathVec libraryFolders = get_library_folders(p_original_path);
 		try {
-			stdLib = mx::createDocument();
-			mx::FilePathVec libraryFolders;
-			libraryFolders.push_back(ProjectSettings::get_singleton()->globalize_path(p_original_path.get_base_dir()).utf8().get_data());
-			libraryFolders.push_back(ProjectSettings::get_singleton()->globalize_path("res://libraries").utf8().get_data());
-			libraryFolders.push_back(ProjectSettings::get_singleton()->globalize_path("user://libraries").utf8().get_data());
-			mx::StringSet xincludeFilesLib = mx::loadLibraries(libraryFolders, searchPath, stdLib);
-			if (xincludeFilesLib.empty()) {
-				std::cerr << "Could not find standard data libraries on the given "
-							 "search path: "
-						  << searchPath.asString() << std::endl;
+			stdLib = get_data_library(libraryFolders, searchPath, p_use_sub_threads);
+			// The material's own folder is a library folder, so check for a
+			// definition of the standard libraries rather than for any library.
+			if (!stdLib || !stdLib->getUnitTypeDef("distance")) {
+				report_error(r_error, String("Could not find standard data libraries on the given search path: ") + String(searchPath.asString().c_str()));
 				return Ref<Resource>();
 			}
 
@@ -132,21 +430,21 @@ Variant MTLXLoader::_load(const String &p_save_path, const String &p_original_pa
 				distanceUnitOptions[location] = unitScale.first;
 			}
 		} catch (std::exception &e) {
-			std::cerr << "Failed to load standard data libraries: " << e.what()
-					  << std::endl;
+			report_error(r_error, String("Failed to load standard data libraries: ") + String(e.what()));
 			return Ref<Resource>();
 		}
-		doc->importLibrary(stdLib);
+		doc->setDataLibrary(stdLib);
 		MaterialX::FilePath parentPath = materialFilename.getParentPath();
 		searchPath.append(materialFilename.getParentPath());
 		// Set up read options.
 		mx::XmlReadOptions readOptions;
-		readOptions.readXIncludeFunction = [](mx::DocumentPtr docLambda,
+		readOptions.readXIncludeFunction = [&xincludeFiles](mx::DocumentPtr docLambda,
 												   const mx::FilePath &filenameLambda,
 												   const mx::FileSearchPath &pathLambda,
 												   const mx::XmlReadOptions *newReadoptions) {
 			mx::FilePath resolvedFilename = pathLambda.find(filenameLambda);
-			if (resolvedFilename.exists()) {
+			if (pathLambda.exists(resolvedFilename)) {
+				xincludeFiles.insert(resolvedFilename.asString());
 				readFromXmlFile(docLambda, resolvedFilename, pathLambda, newReadoptions);
 			} else {
 				std::cerr << "Include file not found: " << filenameLambda.asString()
@@ -154,10 +452,38 @@ Variant MTLXLoader::_load(const String &p_save_path, const String &p_original_pa
 			}
 		};
 		mx::readFromXmlFile(doc, materialFilename, searchPath, &readOptions);
+		for (const std::string &xincludeFile : xincludeFiles) {
+			r_dependencies.push_back(String::utf8(xincludeFile.c_str()));
+		}
 
-		std::string message;
-		bool docValid = doc->validate(&message);
-		ERR_FAIL_COND_V_MSG(!docValid, Ref<Resource>(), String("The MaterialX document is invalid: [") + String(doc->getSourceUri().c_str()) + "] " + String(message.c_str()));
+		mx::ValidationOptions validationOptions;
+		// Imports already run on several threads, so validate on the calling one.
+		validationOptions.threadCount = 1;
+		validationOptions.maxDiagnostics = 32;
+		mx::ValidationDiagnosticVec diagnostics;
+		bool docValid = doc->validateWithDiagnostics(diagnostics, &validationOptions);
+		if (!docValid) {
+			String message = String("The MaterialX document is invalid: [") + String(doc->getSourceUri().c_str()) + "] " + itos(diagnostics.size()) + " error(s)";
+			for (const mx::ValidationDiagnostic &diagnostic : diagnostics) {
+				message += String("\n  ") + String(diagnostic.elementPath.c_str()) + ": " + String(diagnostic.message.c_str()) + " [" + String(diagnostic.rule.c_str()) + "]";
+			}
+			report_error(r_error, message);
+			return Ref<Resource>();
+		}
+
+		if (conversion_mode == CONVERSION_MODE_SHADER_CODE) {
+			mx::FileSearchPath librarySearchPath;
+			librarySearchPath.setFileSystemCache(file_system_cache);
+			for (const mx::FilePath &folder : libraryFolders) {
+				librarySearchPath.append(folder);
+			}
+			String generate_error;
+			Ref<ShaderMaterial> generated = generate_shader_material(doc, librarySearchPath, searchPath, r_dependencies, &generate_error);
+			if (generated.is_valid()) {
+				return generated;
+			}
+			WARN_PRINT(String("Falling back to a VisualShader for ") + p_original_path + ": " + generate_error);
+		}
 
 		Ref<ShaderMaterial> mat;
 		mat.instantiate();
@@ -170,11 +496,167 @@ Variant MTLXLoader::_load(const String &p_save_path, const String &p_original_pa
 		return mat;
 
 	} catch (std::exception &e) {
-		ERR_PRINT(String("Can't load Materialx materials. Error: ") + String(e.what()));
+		report_error(r_error, String("Can't load Materialx materials. Error: ") + String(e.what()));
 		return Ref<Resource>();
 	}
 }
 
+void MTLXLoader::set_gen_options(mx::GenOptions &r_options, bool p_transparent) {
+	// Surfaces the translator recognizes are lit by Godot from their inputs,
+	// so no MaterialX lights are generated. Other surfaces are an unlit
+	// preview: their BSDF is lit only by the environment that
+	// generate_shader_material binds.
+	r_options.hwMaxActiveLightSources = 0;
+	r_options.hwSpecularEnvironmentMethod = mx::SPECULAR_ENVIRONMENT_FIS;
+	r_options.fileTextureVerticalFlip = true;
+	r_options.hwTransparency = p_transparent;
+	// Uniforms are bound once from the document, so constant expressions
+	// are folded into the shader. Input values only change the topology
+	// where they fold, so materials of equal topology still share shaders.
+	r_options.foldInputValues = true;
+}
+
+mx::GenContextCorePtr MTLXLoader::get_gen_context_core(const mx::FileSearchPath &p_library_search_path, const mx::FileSearchPath &p_search_path, bool p_transparent) {
+	String key = String(p_library_search_path.asString().c_str()) + "|" + String(p_search_path.asString().c_str()) + "|" + itos(p_transparent);
+	MutexLock lock(shader_cache_mutex);
+	GenContextCoreEntry *entry = gen_context_cores.getptr(key);
+	if (entry) {
+		return entry->core;
+	}
+
+	mx::GenContext prototype(mx::EsslShaderGenerator::create());
+	prototype.registerSourceCodeSearchPath(p_library_search_path);
+	prototype.registerSourceCodeSearchPath(p_search_path);
+
+	set_gen_options(prototype.getOptions(), p_transparent);
+
+	GenContextCoreEntry created;
+	for (const mx::FileSearchPath *search_path : { &p_library_search_path, &p_search_path }) {
+		for (const mx::FilePath &folder : *search_path) {
+			created.folders.push_back(String(folder.asString().c_str()));
+		}
+	}
+	created.core = mx::GenContextCore::create(mx::EsslShaderGenerator::create, prototype);
+	gen_context_cores.insert(key, created);
+	return created.core;
+}
+
+Ref<ShaderMaterial> MTLXLoader::generate_shader_material(mx::DocumentPtr doc, const mx::FileSearchPath &p_library_search_path, const mx::FileSearchPath &p_search_path, Vector<String> &r_dependencies, String *r_error) const {
+	std::vector<mx::TypedElementPtr> renderables = mx::findRenderableElements(doc);
+	if (renderables.empty()) {
+		report_error(r_error, "The MaterialX document has no renderable element.");
+		return Ref<ShaderMaterial>();
+	}
+	mx::TypedElementPtr element = renderables.front();
+
+	// Each import thread generates with its own context, sharing the node
+	// implementations of every material resolved against the same folders.
+	bool transparent = mx::isTransparentSurface(element, mx::EsslShaderGenerator::TARGET);
+	mx::GenContext context(get_gen_context_core(p_library_search_path, p_search_path, transparent));
+	const mx::GenOptions &options = context.getOptions();
+
+	// Materials sharing a node network get the same generated shader back,
+	// with their own input values to bind to its uniforms.
+	mx::UniformValueMap uniform_values;
+	mx::ShaderPtr generated = shader_cache->getShader(element->getName(), element, context, uniform_values);
+	if (!generated) {
+		report_error(r_error, String("Can't generate shader code for ") + String(element->getNamePath().c_str()));
+		return Ref<ShaderMaterial>();
+	}
+
+	Ref<Shader> shader;
+	{
+		MutexLock lock(shader_cache_mutex);
+		ShaderResourceEntry *entry = shader_resources.getptr(uint64_t(generated.get()));
+		if (entry) {
+			shader = entry->shader;
+		}
+	}
+	if (shader.is_null()) {
+		std::string code;
+		std::string translate_error;
+		if (!MTLXShaderTranslator::translate(generated->getSourceCode(mx::Stage::VERTEX), generated->getSourceCode(mx::Stage::PIXEL), options.hwTransparency, code, translate_error)) {
+			report_error(r_error, String("Can't translate the generated shader: ") + String(translate_error.c_str()));
+			return Ref<ShaderMaterial>();
+		}
+
+		shader.instantiate();
+		shader->set_code(String::utf8(code.c_str()));
+
+		// Keep the resource of whichever thread translated the shader first.
+		MutexLock lock(shader_cache_mutex);
+		ShaderResourceEntry *entry = shader_resources.getptr(uint64_t(generated.get()));
+		if (entry) {
+			shader = entry->shader;
+		} else {
+			shader_resources.insert(uint64_t(generated.get()), ShaderResourceEntry{ generated, shader });
+		}
+	}
+
+	Ref<ShaderMaterial> mat;
+	mat.instantiate();
+	mat->set_shader(shader);
+
+	const mx::VariableBlock &uniforms = generated->getStage(mx::Stage::PIXEL).getUniformBlock(mx::HW::PUBLIC_UNIFORMS);
+	for (size_t i = 0; i < uniforms.size(); i++) {
+		const mx::ShaderPort *port = uniforms[i];
+		auto value_it = uniform_values.find(port->getVariable());
+		if (value_it == uniform_values.end()) {
+			continue;
+		}
+		const mx::ValuePtr &value = value_it->second;
+		StringName parameter = StringName(port->getVariable().c_str());
+		if (port->getType() != mx::Type::FILENAME) {
+			Variant variant_value = get_value_as_variant(value);
+			if (variant_value.get_type() != Variant::NIL) {
+				mat->set_shader_parameter(parameter, variant_value);
+			}
+			continue;
+		}
+
+		mx::FilePath filename = p_search_path.find(value->getValueString());
+		if (filename.isEmpty()) {
+			continue;
+		}
+		const String texture_path = String::utf8(filename.asString().c_str());
+		if (!r_dependencies.has(texture_path)) {
+			r_dependencies.push_back(texture_path);
+		}
+
+		// Textures inside the project are referenced as imported resources,
+		// so that cached materials don't each embed a copy of the image.
+		const String local_path = ProjectSettings::get_singleton()->localize_path(texture_path);
+		if (local_path.begins_with("res://") && ResourceLoader::exists(local_path, "Texture2D")) {
+			Ref<Texture2D> texture = ResourceLoader::load(local_path, "Texture2D");
+			if (texture.is_valid()) {
+				mat->set_shader_parameter(parameter, texture);
+				continue;
+			}
+		}
+		Ref<Image> image = Image::load_from_file(texture_path);
+		if (image.is_null()) {
+			WARN_PRINT(String("Can't load MaterialX texture: ") + texture_path);
+			continue;
+		}
+		mat->set_shader_parameter(parameter, ImageTexture::create_from_image(image));
+	}
+
+	// The unlit preview samples a uniform white environment, so that the
+	// BSDF shows its reflectance rather than black.
+	const mx::VariableBlock &environment = generated->getStage(mx::Stage::PIXEL).getUniformBlock(mx::HW::PRIVATE_UNIFORMS);
+	if (environment.find(mx::HW::ENV_RADIANCE)) {
+		Ref<Image> white = Image::create_empty(1, 1, false, Image::FORMAT_RGB8);
+		white->fill(Color(1, 1, 1));
+		Ref<ImageTexture> texture = ImageTexture::create_from_image(white);
+		mat->set_shader_parameter(StringName(mx::HW::ENV_RADIANCE.c_str()), texture);
+		mat->set_shader_parameter(StringName(mx::HW::ENV_IRRADIANCE.c_str()), texture);
+		mat->set_shader_parameter(StringName(mx::HW::ENV_MATRIX.c_str()), Projection());
+		mat->set_shader_parameter(StringName(mx::HW::ENV_RADIANCE_MIPS.c_str()), 1);
+		mat->set_shader_parameter(StringName(mx::HW::ENV_RADIANCE_SAMPLES.c_str()), 16);
+	}
+	return mat;
+}
+
 void MTLXLoader::process_node_graph(mx::DocumentPtr doc, Ref<VisualShader> shader) const {
 	std::vector<mx::NodeGraphPtr> node_graphs = doc->getNodeGraphs();
 	int node_i = 2;
@@ -34,13 +34,17 @@
 #include "MaterialXCore/Generated.h"
 
 #include "core/io/resource_importer.h"
+#include "core/os/mutex.h"
+#include "core/templates/hash_map.h"
 #include "scene/resources/material.h"
 #include "scene/resources/visual_shader.h"
 
 #include <MaterialXCore/Util.h>
 #include <MaterialXFormat/Util.h>
 #include <MaterialXGenGlsl/EsslShaderGenerator.h>
+#include <MaterialXGenShader/ShaderCache.h>
 
+#include <future>
 #include <iostream>
 #include <map>
 
@@ -48,20 +52,104 @@ using namespace godot;
 namespace mx = MaterialX;
 class MTLXLoader : public RefCounted {
 	GDCLASS(MTLXLoader, RefCounted);
+
+public:
+	enum ConversionMode {
+		CONVERSION_MODE_SHADER_CODE,
+		CONVERSION_MODE_VISUAL_SHADER,
+	};
+
+private:
+	ConversionMode conversion_mode = CONVERSION_MODE_SHADER_CODE;
+
+	// A parsed library folder, shared by every loader call and thread. The
+	// document is never mutated once cached; it is referenced as a data
+	// library by the documents built on top of it instead of being copied.
+	// The entry is published before the folder is parsed, so that other
+	// threads needing the same folder wait for that parse rather than
+	// starting their own, while other folders load in parallel.
+	struct LibraryCacheEntry {
+		String signature;
+		std::shared_future<mx::ConstDocumentPtr> library;
+	};
+	static Mutex library_cache_mutex;
+	static HashMap<String, LibraryCacheEntry> library_cache;
+	// Existence checks and directory listings shared by every import. Entries
+	// for a library folder are only dropped when its signature changes; the
+	// last signature seen for each folder is kept to tell.
+	static mx::FileSystemCachePtr file_system_cache;
+	static Mutex library_signature_mutex;
+	static HashMap<String, String> library_signatures;
+	static String compute_library_signature(const mx::FilePath &p_folder);
+	static String get_library_signature(const mx::FilePath &p_folder);
+	static mx::ConstDocumentPtr get_data_library(const mx::FilePathVec &p_library_folders, const mx::FileSearchPath &p_search_path, bool p_use_sub_threads);
+
+	// Generated shaders keyed by the topology of their shader graphs, so that
+	// materials built from the same node network share one Shader resource
+	// and one compile. Each resource entry holds on to its generated shader,
+	// whose address keys the entry. The topology includes the content of
+	// every node implementation, so entries stay valid when a library
+	// folder changes.
+	struct ShaderResourceEntry {
+		mx::ShaderPtr generated;
+		Ref<Shader> shader;
+	};
+	static Mutex shader_cache_mutex;
+	static mx::ShaderCachePtr shader_cache;
+	static HashMap<uint64_t, ShaderResourceEntry> shader_resources;
+	// Generation state shared by the contexts of every import thread, one
+	// core per set of search paths and transparency, so that the node
+	// implementations of a library are created once rather than per material.
+	// A core caches implementations by name, so it is dropped when any folder
+	// on its search paths changes.
+	struct GenContextCoreEntry {
+		Vector<String> folders;
+		mx::GenContextCorePtr core;
+	};
+	static HashMap<String, GenContextCoreEntry> gen_context_cores;
+	static mx::GenContextCorePtr get_gen_context_core(const mx::FileSearchPath &p_library_search_path, const mx::FileSearchPath &p_search_path, bool p_transparent);
+	static void evict_gen_context_cores(const mx::FilePath &p_folder);
+	static void clear_shader_cache();
+
+	// Converted materials are cached under the imported files path. Bump
+	// this whenever the conversion output changes; the MaterialX version and
+	// generation options are part of the cache hash already.
+	static const int CACHE_FORMAT_VERSION = 4;
+	static mx::FilePathVec get_library_folders(const String &p_original_path);
+	static String get_cache_path(const String &p_original_path);
+	String get_cache_hash(const String &p_original_path, const Vector<String> &p_dependencies) const;
+	Ref<Resource> load_cached_material(const String &p_original_path) const;
+	void save_cached_material(const String &p_original_path, const Ref<Resource> &p_material, const Vector<String> &p_dependencies) const;
+	Ref<Resource> convert_material(const String &p_original_path, Vector<String> &r_dependencies, String *r_error, bool p_use_sub_threads) const;
+
+	Ref<ShaderMaterial> generate_shader_material(mx::DocumentPtr doc, const mx::FileSearchPath &p_library_search_path, const mx::FileSearchPath &p_search_path, Vector<String> &r_dependencies, String *r_error) const;
 	void process_node_graph(mx::DocumentPtr doc, Ref<VisualShader> shader) const;
 	void process_node(const mx::NodePtr &node, Ref<VisualShader> shader, int node_i) const;
 	void add_input_port(mx::InputPtr input, Ref<VisualShaderNodeExpression> expression_node, int input_port_i) const;
 	void add_output_port(mx::OutputPtr output, Ref<VisualShaderNodeExpression> expression_node) const;
 	static Variant get_value_as_variant(const mx::ValuePtr &value);
+	static void report_error(String *r_error, const String &p_message);
 
 protected:
 	static void _bind_methods();
 
 public:
 	virtual Variant _load(const String &p_save_path, const String &p_original_path, bool p_use_sub_threads, int64_t p_cache_mode) const;
+	// Convert a MaterialX file, or return its cached conversion. With
+	// p_use_sub_threads, library folders are parsed on worker threads;
+	// callers already running on the worker pool should pass false.
+	Ref<Resource> load_material(const String &p_original_path, String *r_error = nullptr, bool p_use_sub_threads = false) const;
+	static void clear_library_cache();
+	// Set the generation options the loader converts materials with.
+	static void set_gen_options(mx::GenOptions &r_options, bool p_transparent);
+	void set_conversion_mode(ConversionMode p_mode);
+	ConversionMode get_conversion_mode() const;
 	MTLXLoader() {
 	}
 };
+
+VARIANT_ENUM_CAST(MTLXLoader::ConversionMode);
+
 using MaterialPtr = std::shared_ptr<class Material>;
 
 #endif // MATERIAL_X_3D_H
\ No newline at end of file
@@ -0,0 +1,1288 @@
+/**************************************************************************/
+/*  material_x_shader_translator.cpp                                      */
+/**************************************************************************/
+/*                         This file is part of:                          */
+/*                             GODOT ENGINE                               */
+/*                        https://godotengine.org                         */
+/**************************************************************************/
+/* Copyright (c) 2014-present Godot Engine contributors (see AUTHORS.md). */
+/* Copyright (c) 2007-2014 Juan Linietsky, Ariel Manzur.                  */
+/*                                                                        */
+/* Permission is hereby granted, free of charge, to any person obtaining  */
+/* a copy of this software and associated documentation files (the        */
+/* "Software"), to deal in the Software without restriction, including    */
+/* without limitation the rights to use, copy, modify, merge, publish,    */
+/* distribute, sublicense, and/or sell copies of the Software, and to     */
+/* permit persons to whom the Software is furnished to do so, subject to  */
+/* the following conditions:                                              */
+/*                                                                        */
+/* The above copyright notice and this permission notice shall be         */
+/* included in all copies or substantial portions of the Software.        */
+/*                                                                        */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,        */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF     */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. */
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY   */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,   */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE      */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                 */
+/**************************************************************************/
+
+#include "material_x_shader_translator.h"
+
+#include <algorithm>
+#include <cctype>
+#include <cstdlib>
+#include <cstring>
+
+namespace {
+
+const char *BASE_TYPES[] = {
+	"void", "bool", "int", "uint", "float",
+	"vec2", "vec3", "vec4", "ivec2", "ivec3", "ivec4",
+	"uvec2", "uvec3", "uvec4", "bvec2", "bvec3", "bvec4",
+	"mat2", "mat3", "mat4",
+	"sampler2D", "sampler3D", "samplerCube", "sampler2DArray", "isampler2D", "usampler2D"
+};
+
+const char *OPERATORS[] = {
+	"<<=", ">>=", "++", "--", "+=", "-=", "*=", "/=", "%=", "&=", "|=", "^=",
+	"==", "!=", "<=", ">=", "&&", "||", "^^", "<<", ">>"
+};
+
+// Uniforms and built-ins provided by the MaterialX viewer which have a direct
+// Godot equivalent.
+const std::map<std::string, std::string> STAGE_BUILTINS = {
+	{ "gl_FragCoord", "FRAGCOORD" },
+	{ "gl_FrontFacing", "FRONT_FACING" },
+	{ "u_time", "TIME" },
+	{ "u_viewPosition", "CAMERA_POSITION_WORLD" },
+	{ "u_worldMatrix", "MODEL_MATRIX" },
+	{ "u_worldInverseTransposeMatrix", "transpose(inverse(MODEL_MATRIX))" },
+	{ "u_viewMatrix", "VIEW_MATRIX" },
+	{ "u_viewInverseMatrix", "INV_VIEW_MATRIX" },
+	{ "u_projectionMatrix", "PROJECTION_MATRIX" },
+	{ "u_viewProjectionMatrix", "(PROJECTION_MATRIX * VIEW_MATRIX)" },
+	{ "u_worldViewProjectionMatrix", "(PROJECTION_MATRIX * VIEW_MATRIX * MODEL_MATRIX)" },
+};
+
+const std::map<std::string, std::string> VERTEX_INPUTS = {
+	{ "i_position", "VERTEX" },
+	{ "i_normal", "NORMAL" },
+	{ "i_tangent", "TANGENT" },
+	{ "i_bitangent", "BINORMAL" },
+	{ "i_texcoord_0", "UV" },
+	{ "i_texcoord_1", "UV2" },
+	{ "i_color_0", "COLOR" },
+};
+
+// Shading models Godot's own lighting stands in for, recognized by the input
+// names of the function generated for them. Each Godot output is written from
+// an expression over those inputs; normals are in world space, except for
+// UsdPreviewSurface, whose normal is a tangent space vector.
+struct SurfaceModel {
+	std::vector<std::string> parameters;
+	std::vector<std::pair<std::string, std::string>> outputs;
+	std::string alpha;
+};
+
+const SurfaceModel SURFACE_MODELS[] = {
+	{
+			{ "base", "base_color", "metalness", "specular_roughness", "emission", "emission_color", "opacity", "normal" },
+			{
+					{ "ALBEDO", "base * base_color" },
+					{ "METALLIC", "metalness" },
+					{ "ROUGHNESS", "specular_roughness" },
+					{ "EMISSION", "emission * emission_color" },
+					{ "NORMAL", "normalize((VIEW_MATRIX * vec4(normal, 0.0)).xyz)" },
+			},
+			"dot(opacity, vec3(1.0 / 3.0))",
+	},
+	{
+			{ "base_color", "metallic", "roughness", "occlusion", "emissive", "emissive_strength", "alpha", "normal" },
+			{
+					{ "ALBEDO", "base_color" },
+					{ "METALLIC", "metallic" },
+					{ "ROUGHNESS", "roughness" },
+					{ "AO", "occlusion" },
+					{ "EMISSION", "emissive * emissive_strength" },
+					{ "NORMAL", "normalize((VIEW_MATRIX * vec4(normal, 0.0)).xyz)" },
+			},
+			"alpha",
+	},
+	{
+			{ "diffuseColor", "metallic", "roughness", "occlusion", "emissiveColor", "opacity", "normal" },
+			{
+					{ "ALBEDO", "diffuseColor" },
+					{ "METALLIC", "metallic" },
+					{ "ROUGHNESS", "roughness" },
+					{ "AO", "occlusion" },
+					{ "EMISSION", "emissiveColor" },
+					{ "NORMAL_MAP", "normal * 0.5 + 0.5" },
+			},
+			"opacity",
+	},
+};
+
+const char *SURFACE_PREFIX = "surface_";
+
+} // namespace
+
+std::vector<MTLXShaderTranslator::Token> MTLXShaderTranslator::tokenize(const std::string &p_source) {
+	std::vector<Token> result;
+	size_t i = 0;
+	const size_t size = p_source.size();
+	bool line_start = true;
+	while (i < size) {
+		const char c = p_source[i];
+		if (c == '\n') {
+			line_start = true;
+			i++;
+			continue;
+		}
+		if (isspace((unsigned char)c)) {
+			i++;
+			continue;
+		}
+		if (c == '/' && i + 1 < size && p_source[i + 1] == '/') {
+			while (i < size && p_source[i] != '\n') {
+				i++;
+			}
+			continue;
+		}
+		if (c == '/' && i + 1 < size && p_source[i + 1] == '*') {
+			size_t end = p_source.find("*/", i + 2);
+			i = end == std::string::npos ? size : end + 2;
+			continue;
+		}
+
+		Token token;
+		token.start = i;
+		if (c == '#' && line_start) {
+			token.type = Token::TK_DIRECTIVE;
+			while (i < size && p_source[i] != '\n') {
+				i += (p_source[i] == '\\' && i + 1 < size) ? 2 : 1;
+			}
+		} else if (isalpha((unsigned char)c) || c == '_') {
+			token.type = Token::TK_IDENTIFIER;
+			while (i < size && (isalnum((unsigned char)p_source[i]) || p_source[i] == '_')) {
+				i++;
+			}
+		} else if (isdigit((unsigned char)c) || (c == '.' && i + 1 < size && isdigit((unsigned char)p_source[i + 1]))) {
+			token.type = Token::TK_NUMBER;
+			bool hex = c == '0' && i + 1 < size && (p_source[i + 1] == 'x' || p_source[i + 1] == 'X');
+			i += hex ? 2 : 0;
+			while (i < size) {
+				const char d = p_source[i];
+				if (isalnum((unsigned char)d) || d == '.') {
+					i++;
+				} else if (!hex && (d == '+' || d == '-') && (p_source[i - 1] == 'e' || p_source[i - 1] == 'E')) {
+					i++;
+				} else {
+					break;
+				}
+			}
+		} else {
+			token.type = Token::TK_PUNCTUATION;
+			size_t length = 1;
+			for (const char *op : OPERATORS) {
+				if (p_source.compare(i, strlen(op), op) == 0) {
+					length = strlen(op);
+					break;
+				}
+			}
+			i += length;
+		}
+		line_start = false;
+		token.length = i - token.start;
+		token.text = p_source.substr(token.start, token.length);
+		result.push_back(token);
+	}
+	return result;
+}
+
+bool MTLXShaderTranslator::is_qualifier(const std::string &p_text) {
+	static const std::set<std::string> qualifiers = {
+		"uniform", "const", "in", "out", "inout", "flat", "smooth", "centroid", "invariant", "highp", "mediump", "lowp"
+	};
+	return qualifiers.count(p_text) > 0;
+}
+
+int MTLXShaderTranslator::get_component_count(const std::string &p_type) {
+	if (p_type == "float" || p_type == "int" || p_type == "uint" || p_type == "bool") {
+		return 1;
+	}
+	size_t prefix = p_type.find("vec");
+	if (prefix != std::string::npos && prefix <= 1 && p_type.size() == prefix + 4) {
+		return p_type.back() - '0';
+	}
+	return 0;
+}
+
+std::string MTLXShaderTranslator::get_scalar_type(const std::string &p_type) {
+	if (get_component_count(p_type) == 1) {
+		return p_type;
+	}
+	switch (p_type[0]) {
+		case 'i':
+			return "int";
+		case 'u':
+			return "uint";
+		case 'b':
+			return "bool";
+		default:
+			return "float";
+	}
+}
+
+std::string MTLXShaderTranslator::make_vector_type(const std::string &p_scalar, int p_count) {
+	if (p_count <= 1) {
+		return p_scalar;
+	}
+	std::string prefix = p_scalar == "int" ? "i" : p_scalar == "uint" ? "u" : p_scalar == "bool" ? "b" : "";
+	return prefix + "vec" + std::to_string(p_count);
+}
+
+bool MTLXShaderTranslator::is_matrix_type(const std::string &p_type) {
+	return p_type.compare(0, 3, "mat") == 0;
+}
+
+bool MTLXShaderTranslator::is_type(const std::string &p_text) const {
+	for (const char *type : BASE_TYPES) {
+		if (p_text == type) {
+			return true;
+		}
+	}
+	return structs.count(p_text) > 0 || type_aliases.count(p_text) > 0;
+}
+
+std::string MTLXShaderTranslator::resolve_type(const std::string &p_type) const {
+	std::string type = p_type;
+	for (int depth = 0; depth < 8; depth++) {
+		auto it = type_aliases.find(type);
+		if (it == type_aliases.end()) {
+			break;
+		}
+		type = it->second;
+	}
+	return type;
+}
+
+size_t MTLXShaderTranslator::find_matching(size_t p_open) const {
+	const std::string &open = tokens[p_open].text;
+	const std::string close = open == "(" ? ")" : open == "[" ? "]" : "}";
+	int depth = 0;
+	for (size_t i = p_open; i < tokens.size(); i++) {
+		if (tokens[i].text == open) {
+			depth++;
+		} else if (tokens[i].text == close && --depth == 0) {
+			return i;
+		}
+	}
+	return tokens.size() - 1;
+}
+
+size_t MTLXShaderTranslator::find_statement_end(size_t p_from) const {
+	int depth = 0;
+	for (size_t i = p_from; i < tokens.size(); i++) {
+		const std::string &text = tokens[i].text;
+		if (text == "(" || text == "[" || text == "{") {
+			depth++;
+		} else if (text == ")" || text == "]" || text == "}") {
+			depth--;
+		} else if (text == ";" && depth <= 0) {
+			return i;
+		}
+	}
+	return tokens.size() - 1;
+}
+
+void MTLXShaderTranslator::add_edit(size_t p_first_token, size_t p_last_token, const std::string &p_text) {
+	Edit edit;
+	edit.start = tokens[p_first_token].start;
+	edit.end = tokens[p_last_token].start + tokens[p_last_token].length;
+	edit.text = p_text;
+	edits.push_back(edit);
+}
+
+long MTLXShaderTranslator::evaluate_operand(const std::vector<Token> &p_tokens, size_t &p_index, int p_depth) const {
+	if (p_index >= p_tokens.size()) {
+		return 0;
+	}
+	const Token &token = p_tokens[p_index++];
+	if (token.text == "!") {
+		return !evaluate_operand(p_tokens, p_index, p_depth);
+	}
+	if (token.text == "-") {
+		return -evaluate_operand(p_tokens, p_index, p_depth);
+	}
+	if (token.text == "(") {
+		long value = evaluate_binary(p_tokens, p_index, 0, p_depth);
+		p_index++;
+		return value;
+	}
+	if (token.type == Token::TK_NUMBER) {
+		return strtol(token.text.c_str(), nullptr, 0);
+	}
+	if (token.text == "defined") {
+		bool parenthesis = p_index < p_tokens.size() && p_tokens[p_index].text == "(";
+		p_index += parenthesis ? 1 : 0;
+		bool defined = p_index < p_tokens.size() && macro_values.count(p_tokens[p_index].text);
+		p_index += parenthesis ? 2 : 1;
+		return defined;
+	}
+	auto it = macro_values.find(token.text);
+	return it != macro_values.end() && p_depth < 8 ? evaluate_condition(it->second, p_depth + 1) : 0;
+}
+
+long MTLXShaderTranslator::evaluate_binary(const std::vector<Token> &p_tokens, size_t &p_index, int p_min_precedence, int p_depth) const {
+	static const std::map<std::string, int> precedence = {
+		{ "||", 1 }, { "&&", 2 }, { "==", 3 }, { "!=", 3 }, { "<", 4 }, { ">", 4 }, { "<=", 4 }, { ">=", 4 },
+		{ "+", 5 }, { "-", 5 }, { "*", 6 }, { "/", 6 }, { "%", 6 }
+	};
+
+	long left = evaluate_operand(p_tokens, p_index, p_depth);
+	while (p_index < p_tokens.size()) {
+		const std::string op = p_tokens[p_index].text;
+		auto it = precedence.find(op);
+		if (it == precedence.end() || it->second < p_min_precedence) {
+			break;
+		}
+		p_index++;
+		long right = evaluate_binary(p_tokens, p_index, it->second + 1, p_depth);
+		if (op == "||") {
+			left = left || right;
+		} else if (op == "&&") {
+			left = left && right;
+		} else if (op == "==") {
+			left = left == right;
+		} else if (op == "!=") {
+			left = left != right;
+		} else if (op == "<") {
+			left = left < right;
+		} else if (op == ">") {
+			left = left > right;
+		} else if (op == "<=") {
+			left = left <= right;
+		} else if (op == ">=") {
+			left = left >= right;
+		} else if (op == "+") {
+			left = left + right;
+		} else if (op == "-") {
+			left = left - right;
+		} else if (op == "*") {
+			left = left * right;
+		} else if (right != 0) {
+			left = op == "/" ? left / right : left % right;
+		}
+	}
+	return left;
+}
+
+long MTLXShaderTranslator::evaluate_condition(const std::string &p_expression, int p_depth) const {
+	std::vector<Token> expression = tokenize(p_expression);
+	size_t index = 0;
+	return evaluate_binary(expression, index, 0, p_depth);
+}
+
+void MTLXShaderTranslator::preprocess() {
+	// Conditional blocks are resolved here since their inactive branches may
+	// hold code for other targets, like the Metal struct constructors.
+	struct Conditional {
+		bool parent_active = true;
+		bool taken = false;
+	};
+	std::vector<Conditional> conditionals;
+	std::vector<Token> kept;
+	bool active = true;
+	size_t removed_from = std::string::npos;
+	size_t removed_to = 0;
+
+	for (const Token &token : tokens) {
+		std::string directive;
+		std::string argument;
+		if (token.type == Token::TK_DIRECTIVE) {
+			size_t name = token.text.find_first_not_of(" \t", 1);
+			size_t name_end = token.text.find_first_of(" \t(", name);
+			directive = token.text.substr(name, name_end == std::string::npos ? std::string::npos : name_end - name);
+			argument = name_end == std::string::npos ? std::string() : token.text.substr(name_end);
+		}
+
+		const bool conditional = directive == "if" || directive == "ifdef" || directive == "ifndef" || directive == "elif" || directive == "else" || directive == "endif";
+		if (!conditional && active) {
+			if (removed_from != std::string::npos) {
+				Edit edit;
+				edit.start = removed_from;
+				edit.end = removed_to;
+				edits.push_back(edit);
+				removed_from = std::string::npos;
+			}
+			if (directive == "define") {
+				std::vector<Token> define = tokenize(argument);
+				if (!define.empty()) {
+					size_t value = define[0].start + define[0].length;
+					macro_values[define[0].text] = value < argument.size() ? argument.substr(value) : std::string();
+				}
+			} else if (directive == "undef") {
+				std::vector<Token> undef = tokenize(argument);
+				if (!undef.empty()) {
+					macro_values.erase(undef[0].text);
+				}
+			}
+			kept.push_back(token);
+			continue;
+		}
+
+		removed_from = removed_from == std::string::npos ? token.start : removed_from;
+		removed_to = token.start + token.length;
+		if (!conditional) {
+			continue;
+		}
+		if (directive == "if" || directive == "ifdef" || directive == "ifndef") {
+			Conditional entry;
+			entry.parent_active = active;
+			bool value = false;
+			if (directive == "if") {
+				value = evaluate_condition(argument, 0) != 0;
+			} else {
+				std::vector<Token> name = tokenize(argument);
+				value = !name.empty() && macro_values.count(name[0].text);
+				value = directive == "ifdef" ? value : !value;
+			}
+			active = active && value;
+			entry.taken = active;
+			conditionals.push_back(entry);
+		} else if (!conditionals.empty()) {
+			Conditional &entry = conditionals.back();
+			if (directive == "endif") {
+				active = entry.parent_active;
+				conditionals.pop_back();
+			} else {
+				bool value = directive == "else" || evaluate_condition(argument, 0) != 0;
+				active = entry.parent_active && !entry.taken && value;
+				entry.taken = entry.taken || active;
+			}
+		}
+	}
+	if (removed_from != std::string::npos) {
+		Edit edit;
+		edit.start = removed_from;
+		edit.end = removed_to;
+		edits.push_back(edit);
+	}
+	tokens = kept;
+}
+
+void MTLXShaderTranslator::parse_directive(size_t p_index) {
+	const std::string &text = tokens[p_index].text;
+	if (text.compare(0, 8, "#version") == 0 || text.compare(0, 10, "#extension") == 0) {
+		add_edit(p_index, p_index, "");
+		return;
+	}
+	if (text.compare(0, 7, "#define") != 0) {
+		return;
+	}
+
+	std::vector<Token> define = tokenize(text.substr(7));
+	if (define.size() < 2 || define[0].type != Token::TK_IDENTIFIER || (define[1].text == "(" && define[1].start == define[0].start + define[0].length)) {
+		// Function-like macros are left to the Godot preprocessor.
+		return;
+	}
+	const std::string &name = define[0].text;
+	if (define.size() == 2 && is_type(define[1].text)) {
+		type_aliases[name] = resolve_type(define[1].text);
+		return;
+	}
+	for (size_t i = 1; i < define.size(); i++) {
+		if (define[i].type == Token::TK_NUMBER) {
+			macro_types[name] = get_literal_type(define[i].text);
+			return;
+		}
+		if (is_type(define[i].text)) {
+			macro_types[name] = resolve_type(define[i].text);
+			return;
+		}
+		auto it = macro_types.find(define[i].text);
+		if (it != macro_types.end()) {
+			macro_types[name] = it->second;
+			return;
+		}
+	}
+}
+
+size_t MTLXShaderTranslator::parse_struct(size_t p_index, std::map<std::string, std::string> &r_fields) {
+	size_t close = find_matching(p_index);
+	size_t i = p_index + 1;
+	while (i < close) {
+		while (i < close && is_qualifier(tokens[i].text)) {
+			i++;
+		}
+		const std::string type = tokens[i].text;
+		size_t end = std::min(find_statement_end(i), close);
+		for (size_t j = i + 1; j < end; j++) {
+			if (tokens[j].type == Token::TK_IDENTIFIER && (tokens[j - 1].text == "," || j == i + 1)) {
+				bool array = j + 1 < end && tokens[j + 1].text == "[";
+				r_fields[tokens[j].text] = resolve_type(type) + (array ? "[]" : "");
+			}
+		}
+		i = end + 1;
+	}
+	return close;
+}
+
+void MTLXShaderTranslator::parse_parameters(size_t p_open, size_t p_close, std::vector<std::string> &r_types, std::vector<std::string> &r_names) {
+	std::vector<std::pair<size_t, size_t>> ranges;
+	split_arguments(p_open, p_close, ranges);
+	for (const std::pair<size_t, size_t> &range : ranges) {
+		size_t i = range.first;
+		while (i < range.second && is_qualifier(tokens[i].text)) {
+			i++;
+		}
+		if (i >= range.second || (tokens[i].text == "void" && i + 1 == range.second)) {
+			continue;
+		}
+		std::string type = resolve_type(tokens[i].text);
+		std::string name;
+		if (i + 1 < range.second && tokens[i + 1].type == Token::TK_IDENTIFIER) {
+			name = tokens[i + 1].text;
+			if (i + 2 < range.second && tokens[i + 2].text == "[") {
+				type += "[]";
+			}
+		}
+		r_types.push_back(type);
+		r_names.push_back(name);
+	}
+}
+
+size_t MTLXShaderTranslator::parse_global(size_t p_index) {
+	const Token &token = tokens[p_index];
+	if (token.type == Token::TK_DIRECTIVE) {
+		parse_directive(p_index);
+		return p_index + 1;
+	}
+	if (token.text == "precision") {
+		size_t end = find_statement_end(p_index);
+		add_edit(p_index, end, "");
+		return end + 1;
+	}
+	if (token.text == ";") {
+		return p_index + 1;
+	}
+	if (token.text == "struct") {
+		std::map<std::string, std::string> fields;
+		size_t close = parse_struct(p_index + 2, fields);
+		structs[tokens[p_index + 1].text] = fields;
+		return find_statement_end(close) + 1;
+	}
+
+	std::string storage;
+	size_t i = p_index;
+	while (i < tokens.size() && (is_qualifier(tokens[i].text) || tokens[i].text == "layout")) {
+		if (tokens[i].text == "layout") {
+			i = find_matching(i + 1) + 1;
+			continue;
+		}
+		if (tokens[i].text == "uniform" || tokens[i].text == "in" || tokens[i].text == "out" || tokens[i].text == "const") {
+			storage = tokens[i].text;
+		}
+		i++;
+	}
+	if (i + 2 >= tokens.size() || tokens[i + 1].type != Token::TK_IDENTIFIER) {
+		error = "Unexpected token '" + tokens[std::min(i, tokens.size() - 1)].text + "' at global scope.";
+		return tokens.size();
+	}
+
+	const std::string type = tokens[i].text;
+	if (tokens[i + 2].text == "(") {
+		size_t name = i + 1;
+		size_t close = find_matching(i + 2);
+		Body body;
+		body.name = tokens[name].text;
+		parse_parameters(i + 2, close, body.parameter_types, body.parameter_names);
+
+		Function function;
+		function.return_type = resolve_type(type);
+		function.parameter_types = body.parameter_types;
+		std::vector<Function> &overloads = functions[tokens[name].text];
+		bool known = false;
+		for (const Function &overload : overloads) {
+			known = known || overload.parameter_types == function.parameter_types;
+		}
+		if (!known) {
+			overloads.push_back(function);
+		}
+		function_names.push_back(std::make_pair(name, function.parameter_types));
+
+		if (close + 1 < tokens.size() && tokens[close + 1].text == "{") {
+			body.open = close + 1;
+			body.close = find_matching(body.open);
+			bodies.push_back(body);
+			if (tokens[name].text == "main") {
+				has_main = true;
+				main_name = name;
+				main_open = body.open;
+				main_close = body.close;
+			}
+			return body.close + 1;
+		}
+		return find_statement_end(close) + 1;
+	}
+
+	size_t end = find_statement_end(i);
+	for (size_t j = i + 1; j < end; j++) {
+		if (tokens[j].type != Token::TK_IDENTIFIER || (j != i + 1 && tokens[j - 1].text != ",")) {
+			continue;
+		}
+		bool array = j + 1 < end && tokens[j + 1].text == "[";
+		Declaration declaration;
+		declaration.type = resolve_type(type) + (array ? "[]" : "");
+		declaration.name = tokens[j].text;
+		declaration.first = p_index;
+		declaration.last = end;
+		globals[declaration.name] = declaration.type;
+		if (storage == "uniform") {
+			uniforms.push_back(declaration);
+		} else if (storage == "in") {
+			inputs.push_back(declaration);
+		} else if (storage == "out") {
+			outputs.push_back(declaration);
+		}
+	}
+	return end + 1;
+}
+
+std::string MTLXShaderTranslator::lookup_variable(const std::string &p_name) {
+	for (auto it = scopes.rbegin(); it != scopes.rend(); ++it) {
+		auto found = it->find(p_name);
+		if (found != it->end()) {
+			return found->second;
+		}
+	}
+	auto global = globals.find(p_name);
+	if (global != globals.end()) {
+		return global->second;
+	}
+	auto macro = macro_types.find(p_name);
+	return macro != macro_types.end() ? macro->second : std::string();
+}
+
+std::string MTLXShaderTranslator::get_literal_type(const std::string &p_text) const {
+	if (p_text.size() > 1 && (p_text[1] == 'x' || p_text[1] == 'X')) {
+		return (p_text.back() == 'u' || p_text.back() == 'U') ? "uint" : "int";
+	}
+	if (p_text.back() == 'u' || p_text.back() == 'U') {
+		return "uint";
+	}
+	if (p_text.find_first_of(".eEfF") != std::string::npos) {
+		return "float";
+	}
+	return "int";
+}
+
+std::string MTLXShaderTranslator::infer_expression(size_t &p_index, size_t p_end) {
+	std::string type = infer_assignment(p_index, p_end);
+	while (p_index < p_end && tokens[p_index].text == ",") {
+		p_index++;
+		type = infer_assignment(p_index, p_end);
+	}
+	return type;
+}
+
+std::string MTLXShaderTranslator::infer_assignment(size_t &p_index, size_t p_end) {
+	std::string type = infer_binary(p_index, p_end, 0);
+	if (p_index < p_end && tokens[p_index].text == "?") {
+		p_index++;
+		type = infer_assignment(p_index, p_end);
+		if (p_index < p_end && tokens[p_index].text == ":") {
+			p_index++;
+			std::string other = infer_assignment(p_index, p_end);
+			type = type.empty() ? other : type;
+		}
+		return type;
+	}
+	if (p_index < p_end) {
+		const std::string &op = tokens[p_index].text;
+		if (op == "=" || (op.size() >= 2 && op.back() == '=' && op != "==" && op != "!=" && op != "<=" && op != ">=")) {
+			p_index++;
+			infer_assignment(p_index, p_end);
+		}
+	}
+	return type;
+}
+
+std::string MTLXShaderTranslator::infer_binary(size_t &p_index, size_t p_end, int p_min_precedence) {
+	static const std::map<std::string, int> precedence = {
+		{ "||", 1 }, { "^^", 2 }, { "&&", 3 }, { "|", 4 }, { "^", 5 }, { "&", 6 },
+		{ "==", 7 }, { "!=", 7 }, { "<", 8 }, { ">", 8 }, { "<=", 8 }, { ">=", 8 },
+		{ "<<", 9 }, { ">>", 9 }, { "+", 10 }, { "-", 10 }, { "*", 11 }, { "/", 11 }, { "%", 11 }
+	};
+
+	std::string left = infer_unary(p_index, p_end);
+	while (p_index < p_end) {
+		const std::string op = tokens[p_index].text;
+		auto it = precedence.find(op);
+		if (it == precedence.end() || it->second < p_min_precedence) {
+			break;
+		}
+		p_index++;
+		std::string right = infer_binary(p_index, p_end, it->second + 1);
+		if (it->second <= 3 || it->second == 7 || it->second == 8) {
+			left = "bool";
+		} else if (left.empty() || left == right) {
+			left = right;
+		} else if (right.empty()) {
+			continue;
+		} else if (is_matrix_type(left) && get_component_count(right) > 1) {
+			left = right;
+		} else if (get_component_count(left) == 1) {
+			left = right;
+		}
+	}
+	return left;
+}
+
+std::string MTLXShaderTranslator::infer_unary(size_t &p_index, size_t p_end) {
+	if (p_index >= p_end) {
+		return std::string();
+	}
+	const std::string &op = tokens[p_index].text;
+	if (op == "-" || op == "+" || op == "!" || op == "~" || op == "++" || op == "--") {
+		p_index++;
+		std::string type = infer_unary(p_index, p_end);
+		return op == "!" ? "bool" : type;
+	}
+
+	std::string type = infer_primary(p_index, p_end);
+	while (p_index < p_end) {
+		const std::string &postfix = tokens[p_index].text;
+		if (postfix == "." && p_index + 1 < p_end) {
+			const std::string &member = tokens[p_index + 1].text;
+			p_index += 2;
+			if (member == "length" && p_index < p_end && tokens[p_index].text == "(") {
+				p_index = find_matching(p_index) + 1;
+				type = "int";
+				continue;
+			}
+			auto found = structs.find(type);
+			if (found != structs.end()) {
+				auto field = found->second.find(member);
+				type = field != found->second.end() ? field->second : std::string();
+			} else if (get_component_count(type) > 0) {
+				type = make_vector_type(get_scalar_type(type), int(member.size()));
+			} else {
+				type.clear();
+			}
+		} else if (postfix == "[") {
+			p_index = find_matching(p_index) + 1;
+			if (type.size() > 2 && type.compare(type.size() - 2, 2, "[]") == 0) {
+				type.resize(type.size() - 2);
+			} else if (is_matrix_type(type)) {
+				type = "vec" + type.substr(3, 1);
+			} else if (get_component_count(type) > 1) {
+				type = get_scalar_type(type);
+			} else {
+				type.clear();
+			}
+		} else if (postfix == "++" || postfix == "--") {
+			p_index++;
+		} else {
+			break;
+		}
+	}
+	return type;
+}
+
+std::string MTLXShaderTranslator::infer_primary(size_t &p_index, size_t p_end) {
+	const Token &token = tokens[p_index];
+	if (token.type == Token::TK_NUMBER) {
+		p_index++;
+		return get_literal_type(token.text);
+	}
+	if (token.text == "(") {
+		size_t close = find_matching(p_index);
+		size_t inner = p_index + 1;
+		std::string type = infer_expression(inner, close);
+		p_index = close + 1;
+		return type;
+	}
+	if (token.type != Token::TK_IDENTIFIER) {
+		p_index++;
+		return std::string();
+	}
+	if (token.text == "true" || token.text == "false") {
+		p_index++;
+		return "bool";
+	}
+	if (p_index + 1 < p_end && tokens[p_index + 1].text == "[" && is_type(token.text)) {
+		// Array constructor.
+		size_t close = find_matching(p_index + 1);
+		p_index = close + 1;
+		if (p_index < p_end && tokens[p_index].text == "(") {
+			p_index = find_matching(p_index) + 1;
+		}
+		return resolve_type(token.text) + "[]";
+	}
+	if (p_index + 1 < p_end && tokens[p_index + 1].text == "(") {
+		size_t close = find_matching(p_index + 1);
+		std::string type = infer_call(token.text, p_index + 1, close);
+		p_index = close + 1;
+		return type;
+	}
+	p_index++;
+	return lookup_variable(token.text);
+}
+
+void MTLXShaderTranslator::split_arguments(size_t p_open, size_t p_close, std::vector<std::pair<size_t, size_t>> &r_ranges) const {
+	if (p_close <= p_open + 1) {
+		return;
+	}
+	int depth = 0;
+	size_t start = p_open + 1;
+	for (size_t i = p_open + 1; i < p_close; i++) {
+		const std::string &text = tokens[i].text;
+		if (text == "(" || text == "[" || text == "{") {
+			depth++;
+		} else if (text == ")" || text == "]" || text == "}") {
+			depth--;
+		} else if (text == "," && depth == 0) {
+			r_ranges.push_back(std::make_pair(start, i));
+			start = i + 1;
+		}
+	}
+	r_ranges.push_back(std::make_pair(start, p_close));
+}
+
+std::string MTLXShaderTranslator::infer_builtin(const std::string &p_name, const std::vector<std::string> &p_arguments) const {
+	static const std::set<std::string> float_result = { "length", "distance", "dot", "determinant" };
+	static const std::set<std::string> bool_result = { "any", "all" };
+	static const std::set<std::string> texture_result = { "texture", "textureLod", "textureProj", "textureGrad", "texelFetch", "textureOffset", "textureLodOffset" };
+	static const std::set<std::string> compare_result = { "lessThan", "lessThanEqual", "greaterThan", "greaterThanEqual", "equal", "notEqual", "isnan", "isinf" };
+
+	const std::string first = p_arguments.empty() ? std::string() : p_arguments.front();
+	if (float_result.count(p_name)) {
+		return "float";
+	}
+	if (bool_result.count(p_name)) {
+		return "bool";
+	}
+	if (texture_result.count(p_name)) {
+		return first.compare(0, 1, "i") == 0 ? "ivec4" : first.compare(0, 1, "u") == 0 ? "uvec4" : "vec4";
+	}
+	if (p_name == "textureSize") {
+		return "ivec2";
+	}
+	if (p_name == "cross") {
+		return "vec3";
+	}
+	if (compare_result.count(p_name)) {
+		return make_vector_type("bool", get_component_count(first));
+	}
+	if (p_name == "floatBitsToInt") {
+		return make_vector_type("int", get_component_count(first));
+	}
+	if (p_name == "floatBitsToUint") {
+		return make_vector_type("uint", get_component_count(first));
+	}
+	if (p_name == "intBitsToFloat" || p_name == "uintBitsToFloat") {
+		return make_vector_type("float", get_component_count(first));
+	}
+	if ((p_name == "step" || p_name == "smoothstep") && !p_arguments.empty()) {
+		return p_arguments.back();
+	}
+	return first;
+}
+
+std::string MTLXShaderTranslator::infer_call(const std::string &p_name, size_t p_open, size_t p_close) {
+	if (is_type(p_name)) {
+		return resolve_type(p_name);
+	}
+	auto it = functions.find(p_name);
+	if (it != functions.end()) {
+		if (it->second.size() == 1) {
+			return it->second.front().return_type;
+		}
+		const Function *function = resolve_overload(p_name, p_open, p_close);
+		return function ? function->return_type : std::string();
+	}
+
+	std::vector<std::pair<size_t, size_t>> ranges;
+	split_arguments(p_open, p_close, ranges);
+	std::vector<std::string> arguments;
+	for (const std::pair<size_t, size_t> &range : ranges) {
+		size_t index = range.first;
+		arguments.push_back(infer_assignment(index, range.second));
+	}
+	return infer_builtin(p_name, arguments);
+}
+
+const MTLXShaderTranslator::Function *MTLXShaderTranslator::resolve_overload(const std::string &p_name, size_t p_open, size_t p_close) {
+	std::vector<std::pair<size_t, size_t>> ranges;
+	split_arguments(p_open, p_close, ranges);
+	std::vector<std::string> arguments;
+	for (const std::pair<size_t, size_t> &range : ranges) {
+		size_t index = range.first;
+		arguments.push_back(infer_assignment(index, range.second));
+	}
+
+	// Prefer an exact match, treating unknown argument types as wildcards,
+	// then fall back to matching component counts only.
+	const std::vector<Function> &overloads = functions[p_name];
+	for (int pass = 0; pass < 2; pass++) {
+		for (const Function &function : overloads) {
+			if (function.parameter_types.size() != arguments.size()) {
+				continue;
+			}
+			bool match = true;
+			for (size_t i = 0; i < arguments.size() && match; i++) {
+				const std::string &parameter = function.parameter_types[i];
+				const std::string &argument = arguments[i];
+				if (argument.empty() || argument == parameter) {
+					continue;
+				}
+				match = pass == 1 && get_component_count(argument) > 0 && get_component_count(argument) == get_component_count(parameter);
+			}
+			if (match) {
+				return &function;
+			}
+		}
+	}
+	return nullptr;
+}
+
+void MTLXShaderTranslator::declare_variable(const std::string &p_type, size_t p_name) {
+	bool array = p_name + 1 < tokens.size() && tokens[p_name + 1].text == "[";
+	scopes.back()[tokens[p_name].text] = resolve_type(p_type) + (array ? "[]" : "");
+}
+
+bool MTLXShaderTranslator::resolve_function_body(const Body &p_body) {
+	scopes.clear();
+	scopes.emplace_back();
+	for (size_t i = 0; i < p_body.parameter_names.size(); i++) {
+		scopes.back()[p_body.parameter_names[i]] = p_body.parameter_types[i];
+	}
+
+	for (size_t i = p_body.open + 1; i < p_body.close; i++) {
+		const Token &token = tokens[i];
+		if (token.text == "{") {
+			scopes.emplace_back();
+			continue;
+		}
+		if (token.text == "}") {
+			scopes.pop_back();
+			continue;
+		}
+		if (token.type != Token::TK_IDENTIFIER || tokens[i - 1].text == ".") {
+			continue;
+		}
+
+		const std::string &next = tokens[i + 1].text;
+		if (is_type(token.text) && tokens[i + 1].type == Token::TK_IDENTIFIER) {
+			const std::string &after = tokens[i + 2].text;
+			if (after == "=" || after == ";" || after == "," || after == "[") {
+				declare_variable(token.text, i + 1);
+				// Further declarators in the same statement share the type.
+				int depth = 0;
+				for (size_t j = i + 2; j < p_body.close; j++) {
+					const std::string &text = tokens[j].text;
+					if (text == "(" || text == "[" || text == "{") {
+						depth++;
+					} else if (text == ")" || text == "]" || text == "}") {
+						if (--depth < 0) {
+							break;
+						}
+					} else if (depth == 0 && text == ";") {
+						break;
+					} else if (depth == 0 && text == "," && tokens[j + 1].type == Token::TK_IDENTIFIER) {
+						declare_variable(token.text, j + 1);
+					}
+				}
+			}
+			continue;
+		}
+
+		auto it = functions.find(token.text);
+		if (next == "(" && it != functions.end() && it->second.size() > 1) {
+			const Function *function = resolve_overload(token.text, i + 1, find_matching(i + 1));
+			if (!function) {
+				error = "Can't resolve the overload of '" + token.text + "' called at offset " + std::to_string(token.start) + ".";
+				return false;
+			}
+			add_edit(i, i, function->mangled_name);
+		}
+	}
+	return true;
+}
+
+bool MTLXShaderTranslator::load(const std::string &p_source) {
+	source = p_source;
+	tokens = tokenize(source);
+	preprocess();
+
+	size_t i = 0;
+	while (i < tokens.size() && error.empty()) {
+		i = parse_global(i);
+	}
+	if (!error.empty()) {
+		return false;
+	}
+
+	// Give every overload a distinct name derived from its signature.
+	for (std::pair<const std::string, std::vector<Function>> &entry : functions) {
+		for (Function &function : entry.second) {
+			function.mangled_name = entry.first;
+			if (entry.second.size() > 1) {
+				for (const std::string &type : function.parameter_types) {
+					std::string suffix = type;
+					std::replace(suffix.begin(), suffix.end(), '[', 'a');
+					suffix.erase(std::remove(suffix.begin(), suffix.end(), ']'), suffix.end());
+					function.mangled_name += "_" + suffix;
+				}
+			}
+		}
+	}
+	for (const std::pair<size_t, std::vector<std::string>> &name : function_names) {
+		const std::vector<Function> &overloads = functions[tokens[name.first].text];
+		if (overloads.size() < 2) {
+			continue;
+		}
+		for (const Function &function : overloads) {
+			if (function.parameter_types == name.second) {
+				add_edit(name.first, name.first, function.mangled_name);
+			}
+		}
+	}
+
+	for (const Body &body : bodies) {
+		if (!resolve_function_body(body)) {
+			return false;
+		}
+	}
+	return true;
+}
+
+std::string MTLXShaderTranslator::apply_edits(size_t p_from, size_t p_to) const {
+	// Insertions go first, and an edit covering a whole declaration wins over
+	// the edits nested inside it.
+	std::vector<Edit> sorted = edits;
+	std::sort(sorted.begin(), sorted.end(), [](const Edit &p_a, const Edit &p_b) {
+		if (p_a.start != p_b.start) {
+			return p_a.start < p_b.start;
+		}
+		const bool a_insert = p_a.start == p_a.end;
+		const bool b_insert = p_b.start == p_b.end;
+		if (a_insert != b_insert) {
+			return a_insert;
+		}
+		return p_a.end > p_b.end;
+	});
+
+	std::string result;
+	size_t cursor = p_from;
+	for (const Edit &edit : sorted) {
+		if (edit.start < cursor || edit.end > p_to) {
+			continue;
+		}
+		result += source.substr(cursor, edit.start - cursor);
+		result += edit.text;
+		cursor = edit.end;
+	}
+	result += source.substr(cursor, p_to - cursor);
+	return result;
+}
+
+bool MTLXShaderTranslator::route_surface_outputs(bool p_transparent) {
+	// Only a main() calling exactly one surface shader function can be lit by
+	// Godot; layered or mixed surfaces have no single set of inputs.
+	const Body *surface = nullptr;
+	size_t call = 0;
+	for (size_t i = main_open + 1; i < main_close; i++) {
+		if (tokens[i].type != Token::TK_IDENTIFIER || tokens[i + 1].text != "(") {
+			continue;
+		}
+		for (const Body &body : bodies) {
+			if (body.name != tokens[i].text || body.parameter_types.empty() || body.parameter_types.back() != "surfaceshader") {
+				continue;
+			}
+			if (surface) {
+				return false;
+			}
+			surface = &body;
+			call = i;
+		}
+	}
+	if (!surface) {
+		return false;
+	}
+
+	const SurfaceModel *model = nullptr;
+	std::vector<size_t> indices;
+	for (const SurfaceModel &candidate : SURFACE_MODELS) {
+		indices.clear();
+		for (const std::string &parameter : candidate.parameters) {
+			auto it = std::find(surface->parameter_names.begin(), surface->parameter_names.end(), parameter);
+			if (it == surface->parameter_names.end()) {
+				break;
+			}
+			indices.push_back(it - surface->parameter_names.begin());
+		}
+		if (indices.size() == candidate.parameters.size()) {
+			model = &candidate;
+			break;
+		}
+	}
+	std::vector<std::pair<size_t, size_t>> ranges;
+	const size_t close = find_matching(call + 1);
+	split_arguments(call + 1, close, ranges);
+	if (!model || ranges.size() != surface->parameter_names.size()) {
+		return false;
+	}
+
+	// The call is replaced by a block binding the inputs the model uses to
+	// locals, whose names can't clash with the generated variables.
+	std::string block = "{\n";
+	for (size_t i = 0; i < indices.size(); i++) {
+		const std::pair<size_t, size_t> &range = ranges[indices[i]];
+		const Token &last = tokens[range.second - 1];
+		block += "\t\t" + surface->parameter_types[indices[i]] + " " + SURFACE_PREFIX + model->parameters[i] + " = ";
+		block += apply_edits(tokens[range.first].start, last.start + last.length) + ";\n";
+	}
+	std::vector<std::pair<std::string, std::string>> outputs = model->outputs;
+	if (p_transparent) {
+		outputs.push_back(std::make_pair("ALPHA", model->alpha));
+	}
+	for (const std::pair<std::string, std::string> &output : outputs) {
+		std::string expression;
+		size_t cursor = 0;
+		for (const Token &token : tokenize(output.second)) {
+			if (std::count(model->parameters.begin(), model->parameters.end(), token.text)) {
+				expression += output.second.substr(cursor, token.start - cursor) + SURFACE_PREFIX;
+				cursor = token.start;
+			}
+		}
+		block += "\t\t" + output.first + " = " + expression + output.second.substr(cursor) + ";\n";
+	}
+	block += "\t}";
+	add_edit(call, find_statement_end(close), block);
+	return true;
+}
+
+bool MTLXShaderTranslator::translate(const std::string &p_vertex, const std::string &p_pixel, bool p_transparent, std::string &r_code, std::string &r_error) {
+	MTLXShaderTranslator pixel;
+	if (!pixel.load(p_pixel) || !pixel.has_main) {
+		r_error = "Pixel stage: " + (pixel.error.empty() ? std::string("missing main function.") : pixel.error);
+		return false;
+	}
+	MTLXShaderTranslator vertex;
+	if (!vertex.load(p_vertex) || !vertex.has_main) {
+		r_error = "Vertex stage: " + (vertex.error.empty() ? std::string("missing main function.") : vertex.error);
+		return false;
+	}
+	if (pixel.outputs.size() != 1 || pixel.outputs[0].type != "vec4") {
+		r_error = "Pixel stage: expected a single vec4 output.";
+		return false;
+	}
+
+	// Uniforms Godot provides as built-ins are dropped, and struct uniforms,
+	// which Godot can't declare, become locals of fragment().
+	std::string locals;
+	std::set<std::string> pixel_uniforms;
+	for (const Declaration &uniform : pixel.uniforms) {
+		if (STAGE_BUILTINS.count(uniform.name)) {
+			pixel.add_edit(uniform.first, uniform.last, "");
+		} else if (pixel.structs.count(uniform.type)) {
+			pixel.add_edit(uniform.first, uniform.last, "");
+			locals += "\t" + uniform.type + " " + uniform.name + ";\n";
+		} else {
+			pixel_uniforms.insert(uniform.name);
+		}
+	}
+
+	// Stage inputs become varyings written by vertex().
+	std::string varyings;
+	for (const Declaration &input : pixel.inputs) {
+		pixel.add_edit(input.first, input.last, "");
+		varyings += std::string("varying ") + (get_scalar_type(input.type) == "float" ? "" : "flat ") + input.type + " " + input.name + ";\n";
+	}
+
+	const Declaration &output = pixel.outputs[0];
+	pixel.add_edit(output.first, output.last, "");
+	locals += "\tvec4 " + output.name + " = vec4(0.0);\n";
+
+	for (size_t i = 0; i < pixel.tokens.size(); i++) {
+		const Token &token = pixel.tokens[i];
+		if (token.type != Token::TK_IDENTIFIER || (i > 0 && pixel.tokens[i - 1].text == ".")) {
+			continue;
+		}
+		auto builtin = STAGE_BUILTINS.find(token.text);
+		if (builtin != STAGE_BUILTINS.end()) {
+			pixel.add_edit(i, i, builtin->second);
+		}
+	}
+	pixel.add_edit(pixel.main_name, pixel.main_name, "fragment");
+
+	Edit header;
+	header.start = header.end = pixel.tokens[pixel.main_open].start + 1;
+	header.text = "\n" + locals;
+	pixel.edits.push_back(header);
+
+	// Without a model Godot can light, the color the BSDF computes is shown
+	// as it is.
+	const bool lit = pixel.route_surface_outputs(p_transparent);
+	if (!lit) {
+		Edit footer;
+		footer.start = footer.end = pixel.tokens[pixel.main_close].start;
+		footer.text = "\tALBEDO = " + output.name + ".rgb;\n";
+		if (p_transparent) {
+			footer.text += "\tALPHA = " + output.name + ".a;\n";
+		}
+		pixel.edits.push_back(footer);
+	}
+
+	// Only the body of the vertex main function is kept; its attributes and
+	// transforms map onto the Godot built-ins.
+	for (size_t i = vertex.main_open + 1; i < vertex.main_close; i++) {
+		const Token &token = vertex.tokens[i];
+		if (token.type != Token::TK_IDENTIFIER || vertex.tokens[i - 1].text == ".") {
+			continue;
+		}
+		if (token.text == "gl_Position") {
+			size_t end = vertex.find_statement_end(i);
+			vertex.add_edit(i, end, "");
+			i = end;
+			continue;
+		}
+		auto builtin = STAGE_BUILTINS.find(token.text);
+		auto attribute = VERTEX_INPUTS.find(token.text);
+		if (builtin != STAGE_BUILTINS.end()) {
+			vertex.add_edit(i, i, builtin->second);
+		} else if (attribute != VERTEX_INPUTS.end()) {
+			vertex.add_edit(i, i, attribute->second);
+		} else if (vertex.globals.count(token.text)) {
+			bool input = false;
+			for (const Declaration &declaration : vertex.inputs) {
+				input = input || declaration.name == token.text;
+			}
+			const std::string &type = vertex.globals[token.text];
+			if (input) {
+				// Geometry streams Godot has no equivalent for default to zero.
+				vertex.add_edit(i, i, type + (get_scalar_type(type) == "float" ? "(0.0)" : "(0)"));
+			} else if (!pixel_uniforms.count(token.text)) {
+				bool output_variable = false;
+				for (const Declaration &declaration : vertex.outputs) {
+					output_variable = output_variable || declaration.name == token.text;
+				}
+				if (!output_variable) {
+					r_error = "Vertex stage: unsupported uniform '" + token.text + "'.";
+					return false;
+				}
+			}
+		}
+	}
+	std::string vertex_body = vertex.apply_edits(vertex.tokens[vertex.main_open].start + 1, vertex.tokens[vertex.main_close].start);
+
+	r_code = lit ? "shader_type spatial;\n\n" : "shader_type spatial;\nrender_mode unshaded;\n\n";
+	r_code += varyings;
+	r_code += pixel.apply_edits(0, pixel.source.size());
+	r_code += "\nvoid vertex()\n{" + vertex_body + "}\n";
+	return true;
+}
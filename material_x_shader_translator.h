@@ -0,0 +1,163 @@
+/**************************************************************************/
+/*  material_x_shader_translator.h                                        */
+/**************************************************************************/
+/*                         This file is part of:                          */
+/*                             GODOT ENGINE                               */
+/*                        https://godotengine.org                         */
+/**************************************************************************/
+/* Copyright (c) 2014-present Godot Engine contributors (see AUTHORS.md). */
+/* Copyright (c) 2007-2014 Juan Linietsky, Ariel Manzur.                  */
+/*                                                                        */
+/* Permission is hereby granted, free of charge, to any person obtaining  */
+/* a copy of this software and associated documentation files (the        */
+/* "Software"), to deal in the Software without restriction, including    */
+/* without limitation the rights to use, copy, modify, merge, publish,    */
+/* distribute, sublicense, and/or sell copies of the Software, and to     */
+/* permit persons to whom the Software is furnished to do so, subject to  */
+/* the following conditions:                                              */
+/*                                                                        */
+/* The above copyright notice and this permission notice shall be         */
+/* included in all copies or substantial portions of the Software.        */
+/*                                                                        */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,        */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF     */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. */
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY   */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,   */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE      */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                 */
+/**************************************************************************/
+
+#ifndef MATERIAL_X_SHADER_TRANSLATOR_H
+#define MATERIAL_X_SHADER_TRANSLATOR_H
+
+#include <map>
+#include <set>
+#include <string>
+#include <vector>
+
+// Rewrites the vertex and pixel stages produced by the MaterialX ESSL
+// generator as a single Godot spatial shader.
+//
+// When the material is a single standard_surface, gltf_pbr or
+// UsdPreviewSurface, its inputs are written to the Godot material outputs
+// (ALBEDO, METALLIC, ROUGHNESS, NORMAL, ...) and Godot lights the surface.
+// Any other surface is kept as the generated BSDF and shown unshaded, as an
+// unlit preview under the environment the loader binds.
+//
+// Godot's shading language is close to GLSL ES 3.0, but it has no stage
+// interface blocks, no struct uniforms and no user function overloading,
+// while the MaterialX libraries overload helpers such as mx_square or
+// mx_fresnel_schlick. Overloaded functions are renamed per signature, and
+// every call site is resolved by inferring its argument types.
+class MTLXShaderTranslator {
+	struct Token {
+		enum Type {
+			TK_IDENTIFIER,
+			TK_NUMBER,
+			TK_PUNCTUATION,
+			TK_DIRECTIVE,
+		};
+		Type type = TK_PUNCTUATION;
+		size_t start = 0;
+		size_t length = 0;
+		std::string text;
+	};
+
+	struct Function {
+		std::string return_type;
+		std::vector<std::string> parameter_types;
+		std::string mangled_name;
+	};
+
+	struct Declaration {
+		std::string type;
+		std::string name;
+		size_t first = 0;
+		size_t last = 0;
+	};
+
+	struct Body {
+		std::string name;
+		size_t open = 0;
+		size_t close = 0;
+		std::vector<std::string> parameter_types;
+		std::vector<std::string> parameter_names;
+	};
+
+	struct Edit {
+		size_t start = 0;
+		size_t end = 0;
+		std::string text;
+	};
+
+	std::string source;
+	std::vector<Token> tokens;
+	std::string error;
+
+	std::map<std::string, std::string> type_aliases;
+	std::map<std::string, std::string> macro_types;
+	std::map<std::string, std::string> macro_values;
+	std::map<std::string, std::map<std::string, std::string>> structs;
+	std::map<std::string, std::vector<Function>> functions;
+	std::map<std::string, std::string> globals;
+	std::vector<std::map<std::string, std::string>> scopes;
+	std::vector<std::pair<size_t, std::vector<std::string>>> function_names;
+	std::vector<Body> bodies;
+	std::vector<Declaration> uniforms;
+	std::vector<Declaration> inputs;
+	std::vector<Declaration> outputs;
+	size_t main_name = 0;
+	size_t main_open = 0;
+	size_t main_close = 0;
+	bool has_main = false;
+	std::vector<Edit> edits;
+
+	static std::vector<Token> tokenize(const std::string &p_source);
+	static bool is_qualifier(const std::string &p_text);
+	static int get_component_count(const std::string &p_type);
+	static std::string get_scalar_type(const std::string &p_type);
+	static std::string make_vector_type(const std::string &p_scalar, int p_count);
+	static bool is_matrix_type(const std::string &p_type);
+
+	bool is_type(const std::string &p_text) const;
+	std::string resolve_type(const std::string &p_type) const;
+	size_t find_matching(size_t p_open) const;
+	size_t find_statement_end(size_t p_from) const;
+	void add_edit(size_t p_first_token, size_t p_last_token, const std::string &p_text);
+
+	long evaluate_condition(const std::string &p_expression, int p_depth) const;
+	long evaluate_operand(const std::vector<Token> &p_tokens, size_t &p_index, int p_depth) const;
+	long evaluate_binary(const std::vector<Token> &p_tokens, size_t &p_index, int p_min_precedence, int p_depth) const;
+	void preprocess();
+
+	void parse_directive(size_t p_index);
+	size_t parse_struct(size_t p_index, std::map<std::string, std::string> &r_fields);
+	size_t parse_global(size_t p_index);
+	void parse_parameters(size_t p_open, size_t p_close, std::vector<std::string> &r_types, std::vector<std::string> &r_names);
+
+	std::string lookup_variable(const std::string &p_name);
+	std::string get_literal_type(const std::string &p_text) const;
+	std::string infer_expression(size_t &p_index, size_t p_end);
+	std::string infer_assignment(size_t &p_index, size_t p_end);
+	std::string infer_binary(size_t &p_index, size_t p_end, int p_min_precedence);
+	std::string infer_unary(size_t &p_index, size_t p_end);
+	std::string infer_primary(size_t &p_index, size_t p_end);
+	std::string infer_call(const std::string &p_name, size_t p_open, size_t p_close);
+	std::string infer_builtin(const std::string &p_name, const std::vector<std::string> &p_arguments) const;
+	void split_arguments(size_t p_open, size_t p_close, std::vector<std::pair<size_t, size_t>> &r_ranges) const;
+	const Function *resolve_overload(const std::string &p_name, size_t p_open, size_t p_close);
+	void declare_variable(const std::string &p_type, size_t p_name);
+	bool resolve_function_body(const Body &p_body);
+
+	bool load(const std::string &p_source);
+	std::string apply_edits(size_t p_from, size_t p_to) const;
+	bool route_surface_outputs(bool p_transparent);
+
+public:
+	// Translate the generated stages. Returns false and fills r_error if the
+	// code uses a construct that cannot be expressed in Godot.
+	static bool translate(const std::string &p_vertex, const std::string &p_pixel, bool p_transparent, std::string &r_code, std::string &r_error);
+};
+
+#endif // MATERIAL_X_SHADER_TRANSLATOR_H
@@ -65,4 +65,5 @@ void uninitialize_mtlx_module(ModuleInitializationLevel p_level) {
 	}
 	ResourceLoader::remove_resource_format_loader(resource_format_mtlx);
 	resource_format_mtlx.unref();
+	MTLXLoader::clear_library_cache();
 }
\ No newline at end of file
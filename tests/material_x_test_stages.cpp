@@ -0,0 +1,75 @@
+/**************************************************************************/
+/*  material_x_test_stages.cpp                                            */
+/**************************************************************************/
+/*                         This file is part of:                          */
+/*                             GODOT ENGINE                               */
+/*                        https://godotengine.org                         */
+/**************************************************************************/
+/* Copyright (c) 2014-present Godot Engine contributors (see AUTHORS.md). */
+/* Copyright (c) 2007-2014 Juan Linietsky, Ariel Manzur.                  */
+/*                                                                        */
+/* Permission is hereby granted, free of charge, to any person obtaining  */
+/* a copy of this software and associated documentation files (the        */
+/* "Software"), to deal in the Software without restriction, including    */
+/* without limitation the rights to use, copy, modify, merge, publish,    */
+/* distribute, sublicense, and/or sell copies of the Software, and to     */
+/* permit persons to whom the Software is furnished to do so, subject to  */
+/* the following conditions:                                              */
+/*                                                                        */
+/* The above copyright notice and this permission notice shall be         */
+/* included in all copies or substantial portions of the Software.        */
+/*                                                                        */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,        */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF     */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. */
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY   */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,   */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE      */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                 */
+/**************************************************************************/
+
+#include "material_x_test_stages.h"
+
+#include "../material_x_3d.h"
+
+#include "tests/test_utils.h"
+
+#include <MaterialXFormat/Util.h>
+#include <MaterialXGenGlsl/EsslShaderGenerator.h>
+#include <MaterialXGenShader/Shader.h>
+#include <MaterialXGenShader/Util.h>
+
+namespace mx = MaterialX;
+
+namespace TestMaterialX {
+
+bool generate_essl_stages(const std::string &p_path, std::string &r_vertex, std::string &r_pixel, bool &r_transparent) {
+	const mx::FilePath root = mx::FilePath(TestUtils::get_executable_dir().path_join("../modules/mtlx/thirdparty/mtlx").utf8().get_data());
+	const mx::FileSearchPath search_path(root);
+	try {
+		mx::DocumentPtr library = mx::createDocument();
+		mx::loadLibraries({ "libraries" }, search_path, library);
+		mx::DocumentPtr doc = mx::createDocument();
+		mx::readFromXmlFile(doc, root / p_path, search_path);
+		doc->setDataLibrary(library);
+
+		std::vector<mx::TypedElementPtr> renderables = mx::findRenderableElements(doc);
+		if (renderables.empty()) {
+			return false;
+		}
+		mx::GenContext context(mx::EsslShaderGenerator::create());
+		context.registerSourceCodeSearchPath(search_path);
+		mx::GenOptions &options = context.getOptions();
+		MTLXLoader::set_gen_options(options, mx::isTransparentSurface(renderables.front(), context.getShaderGenerator().getTarget()));
+
+		mx::ShaderPtr shader = context.getShaderGenerator().generate(renderables.front()->getName(), renderables.front(), context);
+		r_vertex = shader->getSourceCode(mx::Stage::VERTEX);
+		r_pixel = shader->getSourceCode(mx::Stage::PIXEL);
+		r_transparent = options.hwTransparency;
+	} catch (std::exception &) {
+		return false;
+	}
+	return true;
+}
+
+} // namespace TestMaterialX
@@ -0,0 +1,164 @@
+/**************************************************************************/
+/*  test_material_x_shader_translator.h                                   */
+/**************************************************************************/
+/*                         This file is part of:                          */
+/*                             GODOT ENGINE                               */
+/*                        https://godotengine.org                         */
+/**************************************************************************/
+/* Copyright (c) 2014-present Godot Engine contributors (see AUTHORS.md). */
+/* Copyright (c) 2007-2014 Juan Linietsky, Ariel Manzur.                  */
+/*                                                                        */
+/* Permission is hereby granted, free of charge, to any person obtaining  */
+/* a copy of this software and associated documentation files (the        */
+/* "Software"), to deal in the Software without restriction, including    */
+/* without limitation the rights to use, copy, modify, merge, publish,    */
+/* distribute, sublicense, and/or sell copies of the Software, and to     */
+/* permit persons to whom the Software is furnished to do so, subject to  */
+/* the following conditions:                                              */
+/*                                                                        */
+/* The above copyright notice and this permission notice shall be         */
+/* included in all copies or substantial portions of the Software.        */
+/*                                                                        */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,        */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF     */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. */
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY   */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,   */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE      */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                 */
+/**************************************************************************/
+
+#ifndef TEST_MATERIAL_X_SHADER_TRANSLATOR_H
+#define TEST_MATERIAL_X_SHADER_TRANSLATOR_H
+
+#include "../material_x_shader_translator.h"
+#include "material_x_test_stages.h"
+
+#include "tests/test_macros.h"
+
+namespace TestMaterialX {
+
+static const char *STANDARD_SURFACE_DEFAULT = "resources/Materials/Examples/StandardSurface/standard_surface_default.mtlx";
+static const char *STANDARD_SURFACE_GLASS = "resources/Materials/Examples/StandardSurface/standard_surface_glass.mtlx";
+
+static bool contains(const std::string &p_code, const std::string &p_text) {
+	return p_code.find(p_text) != std::string::npos;
+}
+
+static std::string translate_example(const char *p_path, bool &r_transparent) {
+	std::string vertex;
+	std::string pixel;
+	REQUIRE(generate_essl_stages(p_path, vertex, pixel, r_transparent));
+	std::string code;
+	std::string error;
+	CHECK_MESSAGE(MTLXShaderTranslator::translate(vertex, pixel, r_transparent, code, error), error.c_str());
+	return code;
+}
+
+TEST_CASE("[Modules][MaterialX] Shader translator maps the stage interface") {
+	bool transparent = true;
+	const std::string code = translate_example(STANDARD_SURFACE_DEFAULT, transparent);
+	CHECK_FALSE(transparent);
+
+	// Material inputs stay uniforms; struct uniforms, which Godot can't
+	// declare, and viewer transforms are replaced.
+	CHECK(contains(code, "\nuniform vec3 SR_default_base_color;"));
+	CHECK_FALSE(contains(code, "uniform displacementshader"));
+	CHECK_FALSE(contains(code, "u_worldMatrix"));
+	CHECK_FALSE(contains(code, "u_viewPosition"));
+
+	// Pixel stage inputs become varyings written by vertex().
+	CHECK(contains(code, "\nvarying vec3 normalWorld;"));
+	CHECK(contains(code, "\nvarying vec3 positionWorld;"));
+	CHECK_FALSE(contains(code, "\nin "));
+	CHECK_FALSE(contains(code, "\nout "));
+	CHECK_FALSE(contains(code, "precision "));
+
+	CHECK(contains(code, "void fragment()"));
+	CHECK(contains(code, "void vertex()"));
+	CHECK_FALSE(contains(code, "void main"));
+	CHECK_FALSE(contains(code, "gl_Position"));
+	CHECK_FALSE(contains(code, "i_position"));
+	CHECK(contains(code, "MODEL_MATRIX * vec4(VERTEX, 1.0)"));
+}
+
+TEST_CASE("[Modules][MaterialX] Shader translator renames overloads") {
+	bool transparent = false;
+	const std::string code = translate_example(STANDARD_SURFACE_DEFAULT, transparent);
+
+	// Every overload of mx_fresnel_schlick gets a name of its own, and no
+	// call is left to the ambiguous name.
+	CHECK(contains(code, "vec3 mx_fresnel_schlick_float_vec3(float cosTheta, vec3 F0)"));
+	CHECK(contains(code, "float mx_fresnel_schlick_float_float(float cosTheta, float F0)"));
+	CHECK(contains(code, "mx_fresnel_schlick_float_vec3("));
+	CHECK_FALSE(contains(code, "mx_fresnel_schlick("));
+	CHECK(contains(code, "mx_square_float("));
+	CHECK(contains(code, "mx_square_vec3("));
+	CHECK_FALSE(contains(code, "mx_square("));
+}
+
+TEST_CASE("[Modules][MaterialX] Shader translator lets Godot light known surfaces") {
+	bool transparent = false;
+	const std::string code = translate_example(STANDARD_SURFACE_DEFAULT, transparent);
+
+	CHECK_FALSE(contains(code, "render_mode unshaded"));
+	CHECK(contains(code, "float surface_base = SR_default_base;"));
+	CHECK(contains(code, "ALBEDO = surface_base * surface_base_color;"));
+	CHECK(contains(code, "METALLIC = surface_metalness;"));
+	CHECK(contains(code, "ROUGHNESS = surface_specular_roughness;"));
+	CHECK(contains(code, "EMISSION = surface_emission * surface_emission_color;"));
+	CHECK(contains(code, "NORMAL = normalize((VIEW_MATRIX * vec4(surface_normal, 0.0)).xyz);"));
+	CHECK_FALSE(contains(code, "NG_standard_surface_surfaceshader_100(SR_default_base"));
+	CHECK_FALSE(contains(code, "ALPHA ="));
+}
+
+TEST_CASE("[Modules][MaterialX] Shader translator writes alpha of transparent surfaces") {
+	bool transparent = false;
+	const std::string code = translate_example(STANDARD_SURFACE_GLASS, transparent);
+	CHECK(transparent);
+	CHECK(contains(code, "ALPHA = dot(surface_opacity, vec3(1.0 / 3.0));"));
+}
+
+TEST_CASE("[Modules][MaterialX] Shader translator shows other surfaces unshaded") {
+	const std::string vertex = R"(#version 300 es
+precision mediump float;
+uniform mat4 u_worldMatrix;
+uniform mat4 u_viewProjectionMatrix;
+in vec3 i_position;
+out vec3 positionWorld;
+void main()
+{
+    vec4 hPositionWorld = u_worldMatrix * vec4(i_position, 1.0);
+    gl_Position = u_viewProjectionMatrix * hPositionWorld;
+    positionWorld = hPositionWorld.xyz;
+}
+)";
+	const std::string pixel = R"(#version 300 es
+precision mediump float;
+uniform vec3 tint;
+in vec3 positionWorld;
+out vec4 out1;
+float mx_square(float x) { return x * x; }
+vec3 mx_square(vec3 x) { return x * x; }
+void main()
+{
+    out1 = vec4(mx_square(tint) * mx_square(positionWorld.x), 0.5);
+}
+)";
+
+	std::string code;
+	std::string error;
+	REQUIRE(MTLXShaderTranslator::translate(vertex, pixel, false, code, error));
+	CHECK(contains(code, "render_mode unshaded;"));
+	CHECK(contains(code, "mx_square_vec3(tint) * mx_square_float(positionWorld.x)"));
+	CHECK(contains(code, "ALBEDO = out1.rgb;"));
+	CHECK_FALSE(contains(code, "ALPHA"));
+	CHECK(contains(code, "vec4 hPositionWorld = MODEL_MATRIX * vec4(VERTEX, 1.0);"));
+
+	REQUIRE(MTLXShaderTranslator::translate(vertex, pixel, true, code, error));
+	CHECK(contains(code, "ALPHA = out1.a;"));
+}
+
+} // namespace TestMaterialX
+
+#endif // TEST_MATERIAL_X_SHADER_TRANSLATOR_H
@@ -102,7 +102,7 @@ InterfaceElementPtr NodeDef::getImplementation(const string& target) const
 bool NodeDef::validate(string* message) const
 {
     bool res = true;
-    validateRequire(!hasType(), res, message, "Nodedef should not have a type but an explicit output");
+    validateRequire(!hasType(), res, message, "Nodedef should not have a type but an explicit output", "nodedef.type");
     return InterfaceElement::validate(message) && res;
 }
 
@@ -148,7 +148,7 @@ NodeDefPtr Implementation::getNodeDef() const
 bool Implementation::validate(string* message) const
 {
     bool res = true;
-    validateRequire(!hasVersionString(), res, message, "Implementation elements do not support version strings");
+    validateRequire(!hasVersionString(), res, message, "Implementation elements do not support version strings", "implementation.version");
     return InterfaceElement::validate(message) && res;
 }
 
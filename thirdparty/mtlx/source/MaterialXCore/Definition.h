@@ -93,7 +93,8 @@ class MX_CORE_API NodeDef : public InterfaceElement
     /// Set the node string of the NodeDef.
     void setNodeString(const string& node)
     {
-        setAttribute(NODE_ATTRIBUTE, node);
+        static const Atom NODE_ATOM(NODE_ATTRIBUTE);
+        setAttribute(NODE_ATOM, node);
     }
 
     /// Return true if the given NodeDef has a node string.
@@ -118,7 +119,8 @@ class MX_CORE_API NodeDef : public InterfaceElement
     /// Set the node group of the NodeDef.
     void setNodeGroup(const string& category)
     {
-        setAttribute(NODE_GROUP_ATTRIBUTE, category);
+        static const Atom NODE_GROUP_ATOM(NODE_GROUP_ATTRIBUTE);
+        setAttribute(NODE_GROUP_ATOM, category);
     }
 
     /// Return true if the given NodeDef has a node group.
@@ -204,7 +206,8 @@ class MX_CORE_API Implementation : public InterfaceElement
     /// Set the file string for the Implementation.
     void setFile(const string& file)
     {
-        setAttribute(FILE_ATTRIBUTE, file);
+        static const Atom FILE_ATOM(FILE_ATTRIBUTE);
+        setAttribute(FILE_ATOM, file);
     }
 
     /// Return true if the given Implementation has a file string.
@@ -226,7 +229,8 @@ class MX_CORE_API Implementation : public InterfaceElement
     /// Set the function string for the Implementation.
     void setFunction(const string& function)
     {
-        setAttribute(FUNCTION_ATTRIBUTE, function);
+        static const Atom FUNCTION_ATOM(FUNCTION_ATTRIBUTE);
+        setAttribute(FUNCTION_ATOM, function);
     }
 
     /// Return true if the given Implementation has a function string.
@@ -248,7 +252,8 @@ class MX_CORE_API Implementation : public InterfaceElement
     /// Set the nodegraph string for the Implementation.
     void setNodeGraph(const string& nodegraph)
     {
-        setAttribute(NODE_GRAPH_ATTRIBUTE, nodegraph);
+        static const Atom NODE_GRAPH_ATOM(NODE_GRAPH_ATTRIBUTE);
+        setAttribute(NODE_GRAPH_ATOM, nodegraph);
     }
 
     /// Return true if the given Implementation has a nodegraph string.
@@ -315,7 +320,8 @@ class MX_CORE_API TypeDef : public Element
     /// Set the semantic string of the TypeDef.
     void setSemantic(const string& semantic)
     {
-        setAttribute(SEMANTIC_ATTRIBUTE, semantic);
+        static const Atom SEMANTIC_ATOM(SEMANTIC_ATTRIBUTE);
+        setAttribute(SEMANTIC_ATOM, semantic);
     }
 
     /// Return true if the given TypeDef has a semantic string.
@@ -337,7 +343,8 @@ class MX_CORE_API TypeDef : public Element
     /// Set the context string of the TypeDef.
     void setContext(const string& context)
     {
-        setAttribute(CONTEXT_ATTRIBUTE, context);
+        static const Atom CONTEXT_ATOM(CONTEXT_ATTRIBUTE);
+        setAttribute(CONTEXT_ATOM, context);
     }
 
     /// Return true if the given TypeDef has a context string.
@@ -460,7 +467,8 @@ class MX_CORE_API UnitDef : public Element
     /// Set the element's unittype string.
     void setUnitType(const string& type)
     {
-        setAttribute(UNITTYPE_ATTRIBUTE, type);
+        static const Atom UNITTYPE_ATOM(UNITTYPE_ATTRIBUTE);
+        setAttribute(UNITTYPE_ATOM, type);
     }
 
     /// Return true if the given element has a unittype string.
@@ -552,7 +560,8 @@ class MX_CORE_API AttributeDef : public TypedElement
     /// Set the element's attrname string.
     void setAttrName(const string& name)
     {
-        setAttribute(ATTRNAME_ATTRIBUTE, name);
+        static const Atom ATTRNAME_ATOM(ATTRNAME_ATTRIBUTE);
+        setAttribute(ATTRNAME_ATOM, name);
     }
 
     /// Return true if this element has an attrname string.
@@ -574,7 +583,8 @@ class MX_CORE_API AttributeDef : public TypedElement
     /// Set the value string of an element.
     void setValueString(const string& value)
     {
-        setAttribute(VALUE_ATTRIBUTE, value);
+        static const Atom VALUE_ATOM(VALUE_ATTRIBUTE);
+        setAttribute(VALUE_ATOM, value);
     }
 
     /// Return true if the given element has a value string.
@@ -631,7 +641,8 @@ class MX_CORE_API AttributeDef : public TypedElement
     /// Set the element's elements string.
     void setElements(const string& elements)
     {
-        setAttribute(ELEMENTS_ATTRIBUTE, elements);
+        static const Atom ELEMENTS_ATOM(ELEMENTS_ATTRIBUTE);
+        setAttribute(ELEMENTS_ATOM, elements);
     }
 
     /// Return true if the element has an elements string.
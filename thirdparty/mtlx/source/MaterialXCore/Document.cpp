@@ -5,7 +5,11 @@
 
 #include <MaterialXCore/Document.h>
 
+#include <algorithm>
+#include <atomic>
+#include <exception>
 #include <mutex>
+#include <thread>
 
 MATERIALX_NAMESPACE_BEGIN
 
@@ -15,6 +19,84 @@ const string Document::CMS_CONFIG_ATTRIBUTE = "cmsconfig";
 namespace
 {
 
+// The source of modification epochs, shared by all documents.
+std::atomic<size_t> modificationCounter(0);
+
+// An upgrade of the document format from one minor version to the next,
+// applied to each element of the tree in turn.  An element upgrade reads
+// and edits only the given element and its children, so that consecutive
+// upgrades can share a single traversal.
+struct ElementUpgrade
+{
+    int fromMinorVersion;
+    int toMinorVersion;
+    void (*apply)(ElementPtr elem);
+};
+
+// The registry of element upgrades, in version order.  Upgrades that depend
+// on other elements of the document remain in Document::upgradeVersion.
+const ElementUpgrade ELEMENT_UPGRADES[] = {
+    { 22, 23, [](ElementPtr elem)
+        {
+            if (elem->getAttribute(TypedElement::TYPE_ATTRIBUTE) == "vector")
+            {
+                elem->setAttribute(TypedElement::TYPE_ATTRIBUTE, getTypeString<Vector3>());
+            }
+        } },
+    { 23, 24, [](ElementPtr elem)
+        {
+            if (elem->getCategory() == "shader" && elem->hasAttribute("shadername"))
+            {
+                elem->setAttribute(NodeDef::NODE_ATTRIBUTE, elem->getAttribute("shadername"));
+                elem->removeAttribute("shadername");
+            }
+            if (elem->isA<Document>())
+            {
+                for (ElementPtr child : elem->getChildrenOfType<Element>("assign"))
+                {
+                    elem->changeChildCategory(child, "materialassign");
+                }
+            }
+        } },
+    { 24, 25, [](ElementPtr elem)
+        {
+            if (elem->isA<Input>() && elem->hasAttribute("graphname"))
+            {
+                elem->setAttribute("opgraph", elem->getAttribute("graphname"));
+                elem->removeAttribute("graphname");
+            }
+        } },
+    { 25, 26, [](ElementPtr elem)
+        {
+            if (elem->getCategory() == "constant")
+            {
+                ElementPtr param = elem->getChild("color");
+                if (param)
+                {
+                    param->setName("value");
+                }
+            }
+        } },
+    { 34, 35, [](ElementPtr elem)
+        {
+            if (elem->getAttribute(TypedElement::TYPE_ATTRIBUTE) == "matrix")
+            {
+                elem->setAttribute(TypedElement::TYPE_ATTRIBUTE, getTypeString<Matrix44>());
+            }
+            if (elem->hasAttribute("default") && !elem->hasAttribute(ValueElement::VALUE_ATTRIBUTE))
+            {
+                elem->setAttribute(ValueElement::VALUE_ATTRIBUTE, elem->getAttribute("default"));
+                elem->removeAttribute("default");
+            }
+
+            MaterialAssignPtr matAssign = elem->asA<MaterialAssign>();
+            if (matAssign)
+            {
+                matAssign->setMaterial(matAssign->getName());
+            }
+        } },
+};
+
 NodeDefPtr getShaderNodeDef(ElementPtr shaderRef)
 {
     if (shaderRef->hasAttribute(NodeDef::NODE_DEF_ATTRIBUTE))
@@ -46,6 +128,24 @@ NodeDefPtr getShaderNodeDef(ElementPtr shaderRef)
     return NodeDefPtr();
 }
 
+// Append the elements of a data library to the local elements of a document,
+// skipping those hidden by a local element of the same name.
+template <class T> void appendDataLibraryElements(vector<shared_ptr<T>>& elements, const vector<shared_ptr<T>>& libraryElements)
+{
+    StringSet localNames;
+    for (const shared_ptr<T>& elem : elements)
+    {
+        localNames.insert(elem->getName());
+    }
+    for (const shared_ptr<T>& elem : libraryElements)
+    {
+        if (!localNames.count(elem->getName()))
+        {
+            elements.push_back(elem);
+        }
+    }
+}
+
 } // anonymous namespace
 
 //
@@ -72,91 +172,180 @@ class Document::Cache
 
     void refresh()
     {
-        // Thread synchronization for multiple concurrent readers of a single document.
+        // Readers of a valid cache proceed without locking, and only a rebuild
+        // is synchronized between multiple concurrent readers of a single document.
+        if (valid.load(std::memory_order_acquire))
+        {
+            return;
+        }
+
         std::lock_guard<std::mutex> guard(mutex);
 
-        if (!valid)
+        if (!valid.load(std::memory_order_relaxed))
         {
             // Clear the existing cache.
             portElementMap.clear();
             nodeDefMap.clear();
             implementationMap.clear();
+            elementKeys.clear();
 
             // Traverse the document to build a new cache.
             for (ElementPtr elem : doc.lock()->traverseTree())
             {
-                const string& nodeName = elem->getAttribute(PortElement::NODE_NAME_ATTRIBUTE);
-                const string& nodeGraphName = elem->getAttribute(PortElement::NODE_GRAPH_ATTRIBUTE);
-                const string& nodeString = elem->getAttribute(NodeDef::NODE_ATTRIBUTE);
-                const string& nodeDefString = elem->getAttribute(InterfaceElement::NODE_DEF_ATTRIBUTE);
+                addElement(elem);
+            }
 
-                if (!nodeName.empty())
-                {
-                    PortElementPtr portElem = elem->asA<PortElement>();
-                    if (portElem)
-                    {
-                        portElementMap.emplace(portElem->getQualifiedName(nodeName), portElem);
-                    }
-                }
-                else
-                {
-                    if (!nodeGraphName.empty())
-                    {
-                        PortElementPtr portElem = elem->asA<PortElement>();
-                        if (portElem)
-                        {
-                            portElementMap.emplace(portElem->getQualifiedName(nodeGraphName), portElem);
-                        }
-                    }
-                }
-                if (!nodeString.empty())
-                {
-                    NodeDefPtr nodeDef = elem->asA<NodeDef>();
-                    if (nodeDef)
-                    {
-                        nodeDefMap.emplace(nodeDef->getQualifiedName(nodeString), nodeDef);
-                    }
-                }
-                if (!nodeDefString.empty())
-                {
-                    InterfaceElementPtr interface = elem->asA<InterfaceElement>();
-                    if (interface)
-                    {
-                        if (interface->isA<NodeGraph>())
-                        {
-                            implementationMap.emplace(interface->getQualifiedName(nodeDefString), interface);
-                        }
-                        ImplementationPtr impl = interface->asA<Implementation>();
-                        if (impl)
-                        {
-                            // Check for implementation which specifies a nodegraph as the implementation
-                            const string& nodeGraphString = impl->getNodeGraph();
-                            if (!nodeGraphString.empty())
-                            {
-                                NodeGraphPtr nodeGraph = impl->getDocument()->getNodeGraph(nodeGraphString);
-                                if (nodeGraph)
-                                    implementationMap.emplace(interface->getQualifiedName(nodeDefString), nodeGraph);
-                            }
-                            else
-                            {
-                                implementationMap.emplace(interface->getQualifiedName(nodeDefString), interface);
-                            }
-                        }
-                    }
-                }
+            valid.store(true, std::memory_order_release);
+        }
+    }
+
+    // Re-index the given element and its descendants after an edit.  Edits
+    // made while the cache is invalid are picked up by the next refresh.
+    // The cache stays valid throughout, so lookups that skip the lock in
+    // refresh are not excluded: edits must not overlap reads on other
+    // threads, as documented on the Document class.
+    void updateTree(ElementPtr elem)
+    {
+        std::lock_guard<std::mutex> guard(mutex);
+
+        if (valid && isAttached(elem))
+        {
+            for (ElementPtr descendant : elem->traverseTree())
+            {
+                removeElement(descendant);
+                addElement(descendant);
             }
+        }
+    }
 
-            valid = true;
+    // Remove the given element and its descendants from the cache, before
+    // they are detached from the document.
+    void removeTree(ElementPtr elem)
+    {
+        std::lock_guard<std::mutex> guard(mutex);
+
+        if (valid)
+        {
+            for (ElementPtr descendant : elem->traverseTree())
+            {
+                removeElement(descendant);
+            }
+        }
+    }
+
+  private:
+    // The keys under which a single element is stored in the cache.
+    struct ElementKeys
+    {
+        string port;
+        string nodeDef;
+        string implementation;
+    };
+
+    bool isAttached(ConstElementPtr elem) const
+    {
+        ConstElementPtr parent = elem->getParent();
+        while (parent)
+        {
+            if (parent->getChild(elem->getName()) != elem)
+            {
+                return false;
+            }
+            elem = parent;
+            parent = elem->getParent();
+        }
+        return elem == doc.lock();
+    }
+
+    void addElement(ElementPtr elem)
+    {
+        static const Atom NODE_NAME_ATOM(PortElement::NODE_NAME_ATTRIBUTE);
+        static const Atom NODE_GRAPH_ATOM(PortElement::NODE_GRAPH_ATTRIBUTE);
+        static const Atom NODE_ATOM(NodeDef::NODE_ATTRIBUTE);
+        static const Atom NODE_DEF_ATOM(InterfaceElement::NODE_DEF_ATTRIBUTE);
+
+        const string& nodeName = elem->getAttribute(NODE_NAME_ATOM);
+        const string& nodeGraphName = elem->getAttribute(NODE_GRAPH_ATOM);
+        const string& nodeString = elem->getAttribute(NODE_ATOM);
+        const string& nodeDefString = elem->getAttribute(NODE_DEF_ATOM);
+
+        ElementKeys keys;
+        const string& portName = !nodeName.empty() ? nodeName : nodeGraphName;
+        if (!portName.empty())
+        {
+            PortElementPtr portElem = elem->asA<PortElement>();
+            if (portElem)
+            {
+                keys.port = portElem->getQualifiedName(portName);
+                portElementMap.emplace(keys.port, portElem);
+            }
+        }
+        if (!nodeString.empty())
+        {
+            NodeDefPtr nodeDef = elem->asA<NodeDef>();
+            if (nodeDef)
+            {
+                keys.nodeDef = nodeDef->getQualifiedName(nodeString);
+                nodeDefMap.emplace(keys.nodeDef, nodeDef);
+            }
+        }
+        if (!nodeDefString.empty())
+        {
+            // Implementations which reference a nodegraph are stored as is,
+            // and resolved at lookup time, so that the nodegraph may be
+            // added or renamed without touching the implementation.
+            InterfaceElementPtr interface = elem->asA<InterfaceElement>();
+            if (interface && (interface->isA<NodeGraph>() || interface->isA<Implementation>()))
+            {
+                keys.implementation = interface->getQualifiedName(nodeDefString);
+                implementationMap.emplace(keys.implementation, interface);
+            }
+        }
+
+        if (!keys.port.empty() || !keys.nodeDef.empty() || !keys.implementation.empty())
+        {
+            elementKeys[elem.get()] = keys;
+        }
+    }
+
+    void removeElement(ElementPtr elem)
+    {
+        auto it = elementKeys.find(elem.get());
+        if (it == elementKeys.end())
+        {
+            return;
+        }
+        eraseValue(portElementMap, it->second.port, elem.get());
+        eraseValue(nodeDefMap, it->second.nodeDef, elem.get());
+        eraseValue(implementationMap, it->second.implementation, elem.get());
+        elementKeys.erase(it);
+    }
+
+    template <class T> static void eraseValue(std::unordered_multimap<string, T>& map, const string& key, const Element* elem)
+    {
+        if (key.empty())
+        {
+            return;
+        }
+        auto keyRange = map.equal_range(key);
+        for (auto it = keyRange.first; it != keyRange.second; ++it)
+        {
+            if (it->second.get() == elem)
+            {
+                map.erase(it);
+                return;
+            }
         }
     }
 
   public:
     weak_ptr<Document> doc;
     std::mutex mutex;
-    bool valid;
+    std::atomic<bool> valid;
     std::unordered_multimap<string, PortElementPtr> portElementMap;
     std::unordered_multimap<string, NodeDefPtr> nodeDefMap;
     std::unordered_multimap<string, InterfaceElementPtr> implementationMap;
+    std::unordered_map<const Element*, ElementKeys> elementKeys;
 };
 
 //
@@ -165,7 +354,13 @@ class Document::Cache
 
 Document::Document(ElementPtr parent, const string& name) :
     GraphElement(parent, CATEGORY, name),
-    _cache(std::make_unique<Cache>())
+    _cache(std::make_unique<Cache>()),
+    _readOnly(false),
+    _modificationEpoch(++modificationCounter),
+    _nodeDefCacheHits(0),
+    _nodeDefCacheMisses(0),
+    _libraryEpoch(0),
+    _hasValidatedElements(false)
 {
 }
 
@@ -177,6 +372,7 @@ void Document::initialize()
 {
     _root = getSelf();
     _cache->doc = getDocument();
+    _dataLibrary = nullptr;
 
     clearContent();
     setVersionIntegers(MATERIALX_MAJOR_VERSION, MATERIALX_MINOR_VERSION);
@@ -237,44 +433,71 @@ void Document::importLibrary(const ConstDocumentPtr& library)
 
     for (auto child : library->getChildren())
     {
-        if (child->getCategory().empty())
-        {
-            throw Exception("Trying to import child without a category: " + child->getName());
-        }
+        importLibraryElement(child);
+    }
+}
 
-        const string childName = child->getQualifiedName(child->getName());
+ElementPtr Document::importLibraryElement(const ConstElementPtr& elem)
+{
+    if (elem->getCategory().empty())
+    {
+        throw Exception("Trying to import child without a category: " + elem->getName());
+    }
 
-        // Check for duplicate elements.
-        ConstElementPtr previous = getChild(childName);
-        if (previous)
-        {
-            continue;
-        }
+    const string childName = elem->getQualifiedName(elem->getName());
 
-        // Create the imported element.
-        ElementPtr childCopy = addChildOfCategory(child->getCategory(), childName);
-        childCopy->copyContentFrom(child);
-        if (!childCopy->hasFilePrefix() && library->hasFilePrefix())
-        {
-            childCopy->setFilePrefix(library->getFilePrefix());
-        }
-        if (!childCopy->hasGeomPrefix() && library->hasGeomPrefix())
-        {
-            childCopy->setGeomPrefix(library->getGeomPrefix());
-        }
-        if (!childCopy->hasColorSpace() && library->hasColorSpace())
-        {
-            childCopy->setColorSpace(library->getColorSpace());
-        }
-        if (!childCopy->hasNamespace() && library->hasNamespace())
-        {
-            childCopy->setNamespace(library->getNamespace());
-        }
-        if (!childCopy->hasSourceUri() && library->hasSourceUri())
+    // Check for duplicate elements.
+    ConstElementPtr previous = getChild(childName);
+    if (previous)
+    {
+        return nullptr;
+    }
+
+    // Create the imported element.
+    ConstDocumentPtr library = elem->getDocument();
+    ElementPtr childCopy = addChildOfCategory(elem->getCategory(), childName);
+    childCopy->copyContentFrom(elem);
+    if (!childCopy->hasFilePrefix() && library->hasFilePrefix())
+    {
+        childCopy->setFilePrefix(library->getFilePrefix());
+    }
+    if (!childCopy->hasGeomPrefix() && library->hasGeomPrefix())
+    {
+        childCopy->setGeomPrefix(library->getGeomPrefix());
+    }
+    if (!childCopy->hasColorSpace() && library->hasColorSpace())
+    {
+        childCopy->setColorSpace(library->getColorSpace());
+    }
+    if (!childCopy->hasNamespace() && library->hasNamespace())
+    {
+        childCopy->setNamespace(library->getNamespace());
+    }
+    if (!childCopy->hasSourceUri() && library->hasSourceUri())
+    {
+        childCopy->setSourceUri(library->getSourceUri());
+    }
+    return childCopy;
+}
+
+ElementPtr Document::materializeDataLibraryElement(const string& name)
+{
+    ElementPtr child = getChild(name);
+    if (child)
+    {
+        return child;
+    }
+
+    for (ConstDocumentPtr library = _dataLibrary; library; library = library->_dataLibrary)
+    {
+        ConstElementPtr libraryChild = library->getChild(name);
+        if (libraryChild)
         {
-            childCopy->setSourceUri(library->getSourceUri());
+            ElementPtr copy = importLibraryElement(libraryChild);
+            return copy ? copy : getChild(libraryChild->getQualifiedName(name));
         }
     }
+    return nullptr;
 }
 
 StringSet Document::getReferencedSourceUris() const
@@ -312,6 +535,13 @@ vector<PortElementPtr> Document::getMatchingPorts(const string& nodeName) const
         ports.push_back(it->second);
     }
 
+    // Append matches from the data library, if any.
+    if (_dataLibrary)
+    {
+        vector<PortElementPtr> libraryMatches = _dataLibrary->getMatchingPorts(nodeName);
+        ports.insert(ports.end(), libraryMatches.begin(), libraryMatches.end());
+    }
+
     // Return the matches.
     return ports;
 }
@@ -357,6 +587,26 @@ vector<OutputPtr> Document::getMaterialOutputs() const
     return materialOutputs;
 }
 
+vector<AttributeDefPtr> Document::getAttributeDefs() const
+{
+    vector<AttributeDefPtr> attributeDefs = getChildrenOfType<AttributeDef>();
+    if (_dataLibrary)
+    {
+        appendDataLibraryElements(attributeDefs, _dataLibrary->getAttributeDefs());
+    }
+    return attributeDefs;
+}
+
+vector<ImplementationPtr> Document::getImplementations() const
+{
+    vector<ImplementationPtr> implementations = getChildrenOfType<Implementation>();
+    if (_dataLibrary)
+    {
+        appendDataLibraryElements(implementations, _dataLibrary->getImplementations());
+    }
+    return implementations;
+}
+
 vector<NodeDefPtr> Document::getMatchingNodeDefs(const string& nodeName) const
 {
     // Refresh the cache.
@@ -370,6 +620,13 @@ vector<NodeDefPtr> Document::getMatchingNodeDefs(const string& nodeName) const
         nodeDefs.push_back(it->second);
     }
 
+    // Append matches from the data library, if any.
+    if (_dataLibrary)
+    {
+        vector<NodeDefPtr> libraryMatches = _dataLibrary->getMatchingNodeDefs(nodeName);
+        nodeDefs.insert(nodeDefs.end(), libraryMatches.begin(), libraryMatches.end());
+    }
+
     // Return the matches.
     return nodeDefs;
 }
@@ -384,7 +641,28 @@ vector<InterfaceElementPtr> Document::getMatchingImplementations(const string& n
     auto keyRange = _cache->implementationMap.equal_range(nodeDef);
     for (auto it = keyRange.first; it != keyRange.second; ++it)
     {
-        implementations.push_back(it->second);
+        // Check for implementation which specifies a nodegraph as the implementation
+        ImplementationPtr impl = it->second->asA<Implementation>();
+        const string& nodeGraphString = impl ? impl->getNodeGraph() : EMPTY_STRING;
+        if (!nodeGraphString.empty())
+        {
+            NodeGraphPtr nodeGraph = impl->getDocument()->getNodeGraph(nodeGraphString);
+            if (nodeGraph)
+            {
+                implementations.push_back(nodeGraph);
+            }
+        }
+        else
+        {
+            implementations.push_back(it->second);
+        }
+    }
+
+    // Append matches from the data library, if any.
+    if (_dataLibrary)
+    {
+        vector<InterfaceElementPtr> libraryMatches = _dataLibrary->getMatchingImplementations(nodeDef);
+        implementations.insert(implementations.end(), libraryMatches.begin(), libraryMatches.end());
     }
 
     // Return the matches.
@@ -395,84 +673,159 @@ bool Document::validate(string* message) const
 {
     bool res = true;
     std::pair<int, int> expectedVersion(MATERIALX_MAJOR_VERSION, MATERIALX_MINOR_VERSION);
-    validateRequire(getVersionIntegers() >= expectedVersion, res, message, "Unsupported document version");
-    validateRequire(getVersionIntegers() <= expectedVersion, res, message, "Future document version");
+    validateRequire(getVersionIntegers() >= expectedVersion, res, message, "Unsupported document version", "document.version.unsupported");
+    validateRequire(getVersionIntegers() <= expectedVersion, res, message, "Future document version", "document.version.future");
     return GraphElement::validate(message) && res;
 }
 
-void Document::upgradeVersion()
+bool Document::validateWithDiagnostics(ValidationDiagnosticVec& diagnostics, const ValidationOptions* options) const
 {
-    std::pair<int, int> documentVersion = getVersionIntegers();
-    std::pair<int, int> expectedVersion(MATERIALX_MAJOR_VERSION, MATERIALX_MINOR_VERSION);
-    if (documentVersion >= expectedVersion)
+    unsigned int threadCount = options ? options->threadCount : 1;
+    size_t maxDiagnostics = options ? options->maxDiagnostics : 0;
+    bool skipValidated = options ? options->skipValidatedLibraryElements : false;
+    if (!threadCount)
     {
-        return;
+        threadCount = std::max(std::thread::hardware_concurrency(), 1u);
     }
-    int majorVersion = documentVersion.first;
-    int minorVersion = documentVersion.second;
 
-    // Upgrade from v1.22 to v1.23
-    if (majorVersion == 1 && minorVersion == 22)
+    // Apply the checks of Document::validate that concern the root element.
+    bool res = true;
+    ValidationDiagnosticVec rootDiagnostics;
     {
-        for (ElementPtr elem : traverseTree())
+        ValidationDiagnosticScope scope(rootDiagnostics);
+        std::pair<int, int> expectedVersion(MATERIALX_MAJOR_VERSION, MATERIALX_MINOR_VERSION);
+        validateRequire(getVersionIntegers() >= expectedVersion, res, nullptr, "Unsupported document version", "document.version.unsupported");
+        validateRequire(getVersionIntegers() <= expectedVersion, res, nullptr, "Future document version", "document.version.future");
+        validateRequire(isValidName(getName()), res, nullptr, "Invalid element name", "element.name");
+        validateRequire(!hasInheritanceCycle(), res, nullptr, "Cycle in element inheritance chain", "element.inherit.cycle");
+    }
+
+    // Determine which library elements passed an earlier validation with no
+    // intervening edit to library content.
+    const vector<ElementPtr>& children = getChildren();
+    size_t libraryEpoch = _dataLibrary ? std::max(_libraryEpoch, _dataLibrary->getModificationEpoch()) : _libraryEpoch;
+    vector<char> skipped(children.size(), false);
+    if (skipValidated && _hasValidatedElements)
+    {
+        std::lock_guard<std::mutex> lock(_validationMutex);
+        for (size_t i = 0; i < children.size(); i++)
         {
-            if (elem->getAttribute(TypedElement::TYPE_ATTRIBUTE) == "vector")
-            {
-                elem->setAttribute(TypedElement::TYPE_ATTRIBUTE, getTypeString<Vector3>());
-            }
+            auto it = _validatedEpochs.find(children[i].get());
+            skipped[i] = it != _validatedEpochs.end() && it->second >= libraryEpoch && isLibraryElement(children[i].get());
         }
-        minorVersion = 23;
     }
 
-    // Upgrade from v1.23 to v1.24
-    if (majorVersion == 1 && minorVersion == 23)
+    // Validate the remaining top-level elements, distributing them across
+    // worker threads.  Each thread collects diagnostics for its elements
+    // separately, so that they can be reported in document order.
+    vector<ValidationDiagnosticVec> childDiagnostics(children.size());
+    vector<char> childValid(children.size(), true);
+    vector<std::exception_ptr> errors(threadCount);
+    std::atomic<size_t> nextChild(0);
+    std::atomic<size_t> diagnosticCount(rootDiagnostics.size());
+    auto validateChildren = [&](size_t threadIndex)
     {
-        for (ElementPtr elem : traverseTree())
+        try
         {
-            if (elem->getCategory() == "shader" && elem->hasAttribute("shadername"))
-            {
-                elem->setAttribute(NodeDef::NODE_ATTRIBUTE, elem->getAttribute("shadername"));
-                elem->removeAttribute("shadername");
-            }
-            for (ElementPtr child : getChildrenOfType<Element>("assign"))
+            for (size_t i = nextChild++; i < children.size(); i = nextChild++)
             {
-                elem->changeChildCategory(child, "materialassign");
+                if (maxDiagnostics && diagnosticCount >= maxDiagnostics)
+                {
+                    break;
+                }
+                if (skipped[i])
+                {
+                    continue;
+                }
+                ValidationDiagnosticScope scope(childDiagnostics[i]);
+                childValid[i] = children[i]->validate();
+                diagnosticCount += childDiagnostics[i].size();
             }
         }
-        minorVersion = 24;
+        catch (...)
+        {
+            errors[threadIndex] = std::current_exception();
+            nextChild = children.size();
+        }
+    };
+    threadCount = (unsigned int) std::min<size_t>(threadCount, children.size());
+    if (threadCount > 1)
+    {
+        vector<std::thread> threads;
+        threads.reserve(threadCount);
+        for (unsigned int i = 0; i < threadCount; i++)
+        {
+            threads.emplace_back(validateChildren, i);
+        }
+        for (std::thread& thread : threads)
+        {
+            thread.join();
+        }
     }
-
-    // Upgrade from v1.24 to v1.25
-    if (majorVersion == 1 && minorVersion == 24)
+    else if (threadCount == 1)
     {
-        for (ElementPtr elem : traverseTree())
+        validateChildren(0);
+    }
+    for (const std::exception_ptr& error : errors)
+    {
+        if (error)
         {
-            if (elem->isA<Input>() && elem->hasAttribute("graphname"))
-            {
-                elem->setAttribute("opgraph", elem->getAttribute("graphname"));
-                elem->removeAttribute("graphname");
-            }
+            std::rethrow_exception(error);
         }
-        minorVersion = 25;
     }
 
-    // Upgrade from v1.25 to v1.26
-    if (majorVersion == 1 && minorVersion == 25)
+    // Record the library elements that passed validation at this epoch.
+    // Elements referring to other content depend on edits that don't
+    // advance the library epoch, so they are not recorded.
+    if (skipValidated)
     {
-        for (ElementPtr elem : traverseTree())
+        vector<char> recorded(children.size(), false);
+        for (size_t i = 0; i < children.size(); i++)
         {
-            if (elem->getCategory() == "constant")
+            recorded[i] = !skipped[i] && childValid[i] && childDiagnostics[i].empty() &&
+                          isLibraryElement(children[i].get()) && !referencesContent(children[i]);
+        }
+        std::lock_guard<std::mutex> lock(_validationMutex);
+        size_t epoch = getModificationEpoch();
+        for (size_t i = 0; i < children.size(); i++)
+        {
+            if (recorded[i])
             {
-                ElementPtr param = elem->getChild("color");
-                if (param)
-                {
-                    param->setName("value");
-                }
+                _validatedEpochs[children[i].get()] = epoch;
             }
         }
-        minorVersion = 26;
+        _hasValidatedElements = !_validatedEpochs.empty();
     }
 
+    // Report diagnostics in document order.
+    ValidationDiagnosticVec results = std::move(rootDiagnostics);
+    for (size_t i = 0; i < children.size(); i++)
+    {
+        res = childValid[i] && res;
+        results.insert(results.end(), childDiagnostics[i].begin(), childDiagnostics[i].end());
+    }
+    if (maxDiagnostics && results.size() > maxDiagnostics)
+    {
+        results.resize(maxDiagnostics);
+    }
+    diagnostics.insert(diagnostics.end(), results.begin(), results.end());
+    return res;
+}
+
+void Document::upgradeVersion()
+{
+    std::pair<int, int> documentVersion = getVersionIntegers();
+    std::pair<int, int> expectedVersion(MATERIALX_MAJOR_VERSION, MATERIALX_MINOR_VERSION);
+    if (documentVersion >= expectedVersion)
+    {
+        return;
+    }
+    int majorVersion = documentVersion.first;
+    int minorVersion = documentVersion.second;
+
+    // Apply element upgrades up to v1.26 in a single traversal.
+    minorVersion = applyElementUpgrades(majorVersion, minorVersion);
+
     // Upgrade from v1.26 to v1.34
     if (majorVersion == 1 && minorVersion == 26)
     {
@@ -623,29 +976,8 @@ void Document::upgradeVersion()
         minorVersion = 34;
     }
 
-    // Upgrade from v1.34 to v1.35
-    if (majorVersion == 1 && minorVersion == 34)
-    {
-        for (ElementPtr elem : traverseTree())
-        {
-            if (elem->getAttribute(TypedElement::TYPE_ATTRIBUTE) == "matrix")
-            {
-                elem->setAttribute(TypedElement::TYPE_ATTRIBUTE, getTypeString<Matrix44>());
-            }
-            if (elem->hasAttribute("default") && !elem->hasAttribute(ValueElement::VALUE_ATTRIBUTE))
-            {
-                elem->setAttribute(ValueElement::VALUE_ATTRIBUTE, elem->getAttribute("default"));
-                elem->removeAttribute("default");
-            }
-
-            MaterialAssignPtr matAssign = elem->asA<MaterialAssign>();
-            if (matAssign)
-            {
-                matAssign->setMaterial(matAssign->getName());
-            }
-        }
-        minorVersion = 35;
-    }
+    // Apply element upgrades from v1.34 to v1.35.
+    minorVersion = applyElementUpgrades(majorVersion, minorVersion);
 
     // Upgrade from v1.35 to v1.36
     if (majorVersion == 1 && minorVersion == 35)
@@ -1342,9 +1674,143 @@ void Document::upgradeVersion()
     }
 }
 
+int Document::applyElementUpgrades(int majorVersion, int minorVersion)
+{
+    // Gather the consecutive element upgrades that apply from the given version.
+    vector<const ElementUpgrade*> upgrades;
+    for (const ElementUpgrade& upgrade : ELEMENT_UPGRADES)
+    {
+        if (majorVersion == 1 && upgrade.fromMinorVersion == minorVersion)
+        {
+            upgrades.push_back(&upgrade);
+            minorVersion = upgrade.toMinorVersion;
+        }
+    }
+    if (upgrades.empty())
+    {
+        return minorVersion;
+    }
+
+    // Apply them in order to each element as the tree is traversed.
+    for (ElementPtr elem : traverseTree())
+    {
+        for (const ElementUpgrade* upgrade : upgrades)
+        {
+            upgrade->apply(elem);
+        }
+    }
+    return minorVersion;
+}
+
 void Document::invalidateCache()
 {
     _cache->valid = false;
+    markModified();
+}
+
+void Document::updateCache(ElementPtr elem)
+{
+    _cache->updateTree(elem);
+    markModified(elem.get());
+}
+
+void Document::removeFromCache(ElementPtr elem)
+{
+    _cache->removeTree(elem);
+    if (_hasValidatedElements)
+    {
+        // Forget the removed element, whose address may be reused by a new
+        // element that has not been validated.
+        std::lock_guard<std::mutex> lock(_validationMutex);
+        _validatedEpochs.erase(elem.get());
+        _hasValidatedElements = !_validatedEpochs.empty();
+    }
+    markModified(elem.get());
+}
+
+bool Document::referencesContent(const ElementPtr& elem) const
+{
+    auto isContent = [this](ConstElementPtr ref)
+    {
+        if (!ref || ref->getDocument().get() != this)
+        {
+            return false;
+        }
+        while (ref->getParent() && ref->getParent().get() != this)
+        {
+            ref = ref->getParent();
+        }
+        return ref.get() != this && !isLibraryElement(ref.get());
+    };
+
+    for (ElementPtr descendant : elem->traverseTree())
+    {
+        for (ConstElementPtr ancestor : descendant->traverseInheritance())
+        {
+            if (isContent(ancestor))
+            {
+                return true;
+            }
+        }
+        TypedElementPtr typedElem = descendant->asA<TypedElement>();
+        if (typedElem && isContent(typedElem->getTypeDef()))
+        {
+            return true;
+        }
+        NodePtr node = descendant->asA<Node>();
+        if (node && isContent(node->getNodeDef()))
+        {
+            return true;
+        }
+        NodeGraphPtr nodeGraph = descendant->asA<NodeGraph>();
+        if (nodeGraph && isContent(nodeGraph->getNodeDef()))
+        {
+            return true;
+        }
+        ImplementationPtr impl = descendant->asA<Implementation>();
+        if (impl && (isContent(impl->getNodeDef()) || isContent(getNodeGraph(impl->getNodeGraph()))))
+        {
+            return true;
+        }
+        PortElementPtr port = descendant->asA<PortElement>();
+        if (port && (isContent(port->getConnectedNode()) || isContent(port->getConnectedOutput())))
+        {
+            return true;
+        }
+    }
+    return false;
+}
+
+void Document::markModified(const Element* elem)
+{
+    _modificationEpoch = ++modificationCounter;
+    if (!_hasValidatedElements)
+    {
+        return;
+    }
+
+    // Edits to the document itself, or within a library element, may affect
+    // the validity of any library element.
+    const Element* topElem = elem;
+    while (topElem && topElem != this && topElem->getParent().get() != this)
+    {
+        topElem = topElem->getParent().get();
+    }
+    if (!topElem || topElem == this || isLibraryElement(topElem))
+    {
+        _libraryEpoch = _modificationEpoch;
+    }
+}
+
+//
+// ValidationOptions methods
+//
+
+ValidationOptions::ValidationOptions() :
+    threadCount(1),
+    maxDiagnostics(0),
+    skipValidatedLibraryElements(false)
+{
 }
 
 MATERIALX_NAMESPACE_END
@@ -14,9 +14,14 @@
 #include <MaterialXCore/Look.h>
 #include <MaterialXCore/Node.h>
 
+#include <atomic>
+#include <mutex>
+#include <unordered_map>
+
 MATERIALX_NAMESPACE_BEGIN
 
 class Document;
+class ValidationOptions;
 
 /// A shared pointer to a Document
 using DocumentPtr = shared_ptr<Document>;
@@ -28,6 +33,14 @@ using ConstDocumentPtr = shared_ptr<const Document>;
 /// MaterialX ownership hierarchy.
 ///
 /// Use the factory function createDocument() to create a Document instance.
+///
+/// A document may be read from multiple threads concurrently, including the
+/// lookups made by worker threads of validateWithDiagnostics and by shader
+/// generation, and it may be shared as the data library of documents read
+/// on other threads.  Edits are not synchronized with reads: the lookup
+/// cache is updated in place by each edit, so a document, and any document
+/// that uses it as a data library, must not be edited while any other
+/// thread is reading it.
 class MX_CORE_API Document : public GraphElement
 {
   public:
@@ -50,15 +63,58 @@ class MX_CORE_API Document : public GraphElement
     {
         DocumentPtr doc = createDocument<Document>();
         doc->copyContentFrom(getSelf());
+        doc->setDataLibrary(getDataLibrary());
         return doc;
     }
 
     /// Import the given document as a library within this document.
     /// The contents of the library document are copied into this one, and
-    /// are assigned the source URI of the library.
+    /// are assigned the source URI of the library.  To share the content
+    /// of a library between documents without copying it, reference the
+    /// library with setDataLibrary instead.
     /// @param library The library document to be imported.
     void importLibrary(const ConstDocumentPtr& library);
 
+    /// @name Data Library
+    /// @{
+
+    /// Store a reference to a data library in this document.  Unlike
+    /// importLibrary, no content is copied; lookups of definitions by name,
+    /// and matching nodedef, implementation and port queries, fall back to
+    /// the data library when no local element is found.  A data library may
+    /// itself reference a further data library, forming a chain.
+    /// @param dataLibrary The data library document to be referenced.
+    void setDataLibrary(const ConstDocumentPtr& dataLibrary)
+    {
+        _dataLibrary = dataLibrary;
+        markModified();
+    }
+
+    /// Return true if this document references a data library.
+    bool hasDataLibrary() const
+    {
+        return _dataLibrary != nullptr;
+    }
+
+    /// Return the data library, if any, referenced by this document.
+    ConstDocumentPtr getDataLibrary() const
+    {
+        return _dataLibrary;
+    }
+
+    /// Return an editable copy of the given top-level element from the data
+    /// library chain, importing it into this document on first use.  Since
+    /// local elements take precedence over data library elements in all
+    /// lookups, subsequent queries return the copy, while the shared data
+    /// library and the other documents referencing it are unaffected.
+    /// @param name The name of the top-level element to be copied.
+    /// @return The local element of the given name, or an empty shared
+    ///    pointer if neither this document nor its data library chain
+    ///    contains such an element.
+    ElementPtr materializeDataLibraryElement(const string& name);
+
+    /// @}
+
     /// Get a list of source URI's referenced by the document
     StringSet getReferencedSourceUris() const;
 
@@ -78,7 +134,8 @@ class MX_CORE_API Document : public GraphElement
     /// Return the NodeGraph, if any, with the given name.
     NodeGraphPtr getNodeGraph(const string& name) const
     {
-        return getChildOfType<NodeGraph>(name);
+        NodeGraphPtr child = getChildOfType<NodeGraph>(name);
+        return (child || !_dataLibrary) ? child : _dataLibrary->getNodeGraph(name);
     }
 
     /// Return a vector of all NodeGraph elements in the document.
@@ -154,7 +211,8 @@ class MX_CORE_API Document : public GraphElement
     /// Return the GeomPropDef, if any, with the given name.
     GeomPropDefPtr getGeomPropDef(const string& name) const
     {
-        return getChildOfType<GeomPropDef>(name);
+        GeomPropDefPtr child = getChildOfType<GeomPropDef>(name);
+        return (child || !_dataLibrary) ? child : _dataLibrary->getGeomPropDef(name);
     }
 
     /// Return a vector of all GeomPropDef elements in the document.
@@ -289,7 +347,8 @@ class MX_CORE_API Document : public GraphElement
     /// Return the TypeDef, if any, with the given name.
     TypeDefPtr getTypeDef(const string& name) const
     {
-        return getChildOfType<TypeDef>(name);
+        TypeDefPtr child = getChildOfType<TypeDef>(name);
+        return (child || !_dataLibrary) ? child : _dataLibrary->getTypeDef(name);
     }
 
     /// Return a vector of all TypeDef elements in the document.
@@ -349,7 +408,8 @@ class MX_CORE_API Document : public GraphElement
     /// Return the NodeDef, if any, with the given name.
     NodeDefPtr getNodeDef(const string& name) const
     {
-        return getChildOfType<NodeDef>(name);
+        NodeDefPtr child = getChildOfType<NodeDef>(name);
+        return (child || !_dataLibrary) ? child : _dataLibrary->getNodeDef(name);
     }
 
     /// Return a vector of all NodeDef elements in the document.
@@ -384,14 +444,13 @@ class MX_CORE_API Document : public GraphElement
     /// Return the AttributeDef, if any, with the given name.
     AttributeDefPtr getAttributeDef(const string& name) const
     {
-        return getChildOfType<AttributeDef>(name);
+        AttributeDefPtr child = getChildOfType<AttributeDef>(name);
+        return (child || !_dataLibrary) ? child : _dataLibrary->getAttributeDef(name);
     }
 
-    /// Return a vector of all AttributeDef elements in the document.
-    vector<AttributeDefPtr> getAttributeDefs() const
-    {
-        return getChildrenOfType<AttributeDef>();
-    }
+    /// Return a vector of all AttributeDef elements in the document, followed
+    /// by those of its data library that no local element overrides.
+    vector<AttributeDefPtr> getAttributeDefs() const;
 
     /// Remove the AttributeDef, if any, with the given name.
     void removeAttributeDef(const string& name)
@@ -416,7 +475,8 @@ class MX_CORE_API Document : public GraphElement
     /// Return the AttributeDef, if any, with the given name.
     TargetDefPtr getTargetDef(const string& name) const
     {
-        return getChildOfType<TargetDef>(name);
+        TargetDefPtr child = getChildOfType<TargetDef>(name);
+        return (child || !_dataLibrary) ? child : _dataLibrary->getTargetDef(name);
     }
 
     /// Return a vector of all TargetDef elements in the document.
@@ -512,14 +572,13 @@ class MX_CORE_API Document : public GraphElement
     /// Return the Implementation, if any, with the given name.
     ImplementationPtr getImplementation(const string& name) const
     {
-        return getChildOfType<Implementation>(name);
+        ImplementationPtr child = getChildOfType<Implementation>(name);
+        return (child || !_dataLibrary) ? child : _dataLibrary->getImplementation(name);
     }
 
-    /// Return a vector of all Implementation elements in the document.
-    vector<ImplementationPtr> getImplementations() const
-    {
-        return getChildrenOfType<Implementation>();
-    }
+    /// Return a vector of all Implementation elements in the document,
+    /// followed by those of its data library that no local element overrides.
+    vector<ImplementationPtr> getImplementations() const;
 
     /// Remove the Implementation, if any, with the given name.
     void removeImplementation(const string& name)
@@ -548,7 +607,8 @@ class MX_CORE_API Document : public GraphElement
     /// Return the UnitDef, if any, with the given name.
     UnitDefPtr getUnitDef(const string& name) const
     {
-        return getChildOfType<UnitDef>(name);
+        UnitDefPtr child = getChildOfType<UnitDef>(name);
+        return (child || !_dataLibrary) ? child : _dataLibrary->getUnitDef(name);
     }
 
     /// Return a vector of all Member elements in the TypeDef.
@@ -579,7 +639,8 @@ class MX_CORE_API Document : public GraphElement
     /// Return the UnitTypeDef, if any, with the given name.
     UnitTypeDefPtr getUnitTypeDef(const string& name) const
     {
-        return getChildOfType<UnitTypeDef>(name);
+        UnitTypeDefPtr child = getChildOfType<UnitTypeDef>(name);
+        return (child || !_dataLibrary) ? child : _dataLibrary->getUnitTypeDef(name);
     }
 
     /// Return a vector of all UnitTypeDef elements in the document.
@@ -612,7 +673,8 @@ class MX_CORE_API Document : public GraphElement
     /// Set the color management system string.
     void setColorManagementSystem(const string& cms)
     {
-        setAttribute(CMS_ATTRIBUTE, cms);
+        static const Atom CMS_ATOM(CMS_ATTRIBUTE);
+        setAttribute(CMS_ATOM, cms);
     }
 
     /// Return true if a color management system string has been set.
@@ -634,7 +696,8 @@ class MX_CORE_API Document : public GraphElement
     /// Set the color management config string.
     void setColorManagementConfig(const string& cmsConfig)
     {
-        setAttribute(CMS_CONFIG_ATTRIBUTE, cmsConfig);
+        static const Atom CMS_CONFIG_ATOM(CMS_CONFIG_ATTRIBUTE);
+        setAttribute(CMS_CONFIG_ATOM, cmsConfig);
     }
 
     /// Return true if a color management config string has been set.
@@ -660,13 +723,68 @@ class MX_CORE_API Document : public GraphElement
     /// @return True if the document passes all tests, false otherwise.
     bool validate(string* message = nullptr) const override;
 
+    /// Validate that the given document is consistent with the MaterialX
+    /// specification, appending a structured diagnostic for each error.
+    /// The top-level elements of the document are validated independently,
+    /// and may be spread across worker threads, but diagnostics are always
+    /// returned in document order.  The document must not be edited until
+    /// this call returns.
+    /// @param diagnostics The vector to which diagnostics are appended.
+    /// @param options An optional pointer to a ValidationOptions object.
+    ///    If provided, then the given options will affect the behavior of
+    ///    the validation.  Defaults to a null pointer.
+    /// @return True if the validated elements pass all tests, false otherwise.
+    bool validateWithDiagnostics(ValidationDiagnosticVec& diagnostics, const ValidationOptions* options = nullptr) const;
+
     /// @}
     /// @name Utility
     /// @{
 
-    /// Invalidate cached data for optimized lookups within the given document.
+    /// Set the read-only state of this document.  The elements of a read-only
+    /// document cannot be edited, and any attempt to do so throws an
+    /// ExceptionReadOnlyDocument, so a read-only document may safely be
+    /// shared as the data library of many other documents.
+    void setReadOnly(bool readOnly)
+    {
+        _readOnly = readOnly;
+    }
+
+    /// Return true if this document is read-only.
+    bool isReadOnly() const
+    {
+        return _readOnly;
+    }
+
+    /// Invalidate cached data for optimized lookups within the given document,
+    /// forcing a full rebuild on the next lookup.  Edits made through the
+    /// Element API keep the cache up to date incrementally, so this is only
+    /// needed after changes the cache can't observe.
     void invalidateCache();
 
+    /// Return the modification epoch of the document, which changes with
+    /// every edit made through the Element API to this document or to its
+    /// chain of data libraries.  Epochs are unique across all documents, so
+    /// a matching epoch guarantees that no such edit has occurred.
+    size_t getModificationEpoch() const
+    {
+        size_t epoch = _modificationEpoch;
+        return _dataLibrary ? std::max(epoch, _dataLibrary->getModificationEpoch()) : epoch;
+    }
+
+    /// Return the number of Node::getNodeDef calls within this document that
+    /// were answered from the per-node resolution cache.
+    size_t getNodeDefCacheHits() const
+    {
+        return _nodeDefCacheHits;
+    }
+
+    /// Return the number of Node::getNodeDef calls within this document that
+    /// required a full nodedef match.
+    size_t getNodeDefCacheMisses() const
+    {
+        return _nodeDefCacheMisses;
+    }
+
     /// @}
 
   public:
@@ -674,9 +792,83 @@ class MX_CORE_API Document : public GraphElement
     static const string CMS_ATTRIBUTE;
     static const string CMS_CONFIG_ATTRIBUTE;
 
+  private:
+    friend class Element;
+    friend class Node;
+
+    // Incremental maintenance of the lookup cache, called by Element when
+    // the given element or its descendants are edited, added or removed.
+    void updateCache(ElementPtr elem);
+    void removeFromCache(ElementPtr elem);
+
+    // Record an edit to the given element of the document, or to the
+    // document as a whole if no element is given, advancing its
+    // modification epoch.
+    void markModified(const Element* elem = nullptr);
+
+    // Return true if the given top-level element was imported from a library.
+    bool isLibraryElement(const Element* elem) const
+    {
+        return elem->hasSourceUri() && elem->getSourceUri() != getSourceUri();
+    }
+
+    // Return true if the given top-level library element, or one of its
+    // descendants, refers to an element of this document that is not from
+    // a library, so that its validity may change with edits to content.
+    bool referencesContent(const ElementPtr& elem) const;
+
+    // Apply the registered element upgrades that follow on from the given
+    // version in a single traversal, returning the upgraded minor version.
+    int applyElementUpgrades(int majorVersion, int minorVersion);
+
+    // Copy the given top-level library element into this document, as
+    // importLibrary does for each child of a library.
+    ElementPtr importLibraryElement(const ConstElementPtr& elem);
+
   private:
     class Cache;
     std::unique_ptr<Cache> _cache;
+    ConstDocumentPtr _dataLibrary;
+    bool _readOnly;
+    size_t _modificationEpoch;
+    mutable std::atomic<size_t> _nodeDefCacheHits;
+    mutable std::atomic<size_t> _nodeDefCacheMisses;
+
+    // The epoch of the last edit that may affect the validity of library
+    // elements, and the epoch at which each library element last passed
+    // validation.
+    size_t _libraryEpoch;
+    mutable std::atomic<bool> _hasValidatedElements;
+    mutable std::mutex _validationMutex;
+    mutable std::unordered_map<const Element*, size_t> _validatedEpochs;
+};
+
+/// @class ValidationOptions
+/// A set of options for controlling the behavior of
+/// Document::validateWithDiagnostics.
+class MX_CORE_API ValidationOptions
+{
+  public:
+    ValidationOptions();
+    ~ValidationOptions() { }
+
+    /// The number of threads across which the top-level elements of the
+    /// document are validated.  A value of zero selects the number of
+    /// hardware threads.  Defaults to 1.
+    unsigned int threadCount;
+
+    /// If non-zero, then no further top-level elements are validated once
+    /// this many diagnostics have been reported, and at most this many are
+    /// returned.  Defaults to 0.
+    size_t maxDiagnostics;
+
+    /// If true, then library elements, whose source URI differs from that of
+    /// the document, are skipped if they passed an earlier validation and
+    /// no library element, document attribute or data library has been
+    /// edited since.  Library elements that refer to other content of the
+    /// document, such as a nodedef inheriting from a nodedef that is not
+    /// from a library, are always validated.  Defaults to false.
+    bool skipValidatedLibraryElements;
 };
 
 /// Create a new Document.
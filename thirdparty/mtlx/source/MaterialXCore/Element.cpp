@@ -40,6 +40,32 @@ const string ValueElement::UNIFORM_ATTRIBUTE = "uniform";
 
 Element::CreatorMap Element::_creatorMap;
 
+namespace
+{
+
+const size_t INITIAL_ATTRIBUTE_CAPACITY = 4;
+
+// The diagnostics collected by validation on the current thread, if any.
+thread_local ValidationDiagnosticVec* threadValidationDiagnostics = nullptr;
+
+// Return true if the given attribute affects the lookup cache of the document.
+bool isCacheAttribute(const Atom& attrib)
+{
+    static const Atom NODE_NAME_ATOM(PortElement::NODE_NAME_ATTRIBUTE);
+    static const Atom NODE_GRAPH_ATOM(PortElement::NODE_GRAPH_ATTRIBUTE);
+    static const Atom NODE_ATOM(NodeDef::NODE_ATTRIBUTE);
+    static const Atom NODE_DEF_ATOM(InterfaceElement::NODE_DEF_ATTRIBUTE);
+    static const Atom NAMESPACE_ATOM(Element::NAMESPACE_ATTRIBUTE);
+
+    return attrib == NODE_NAME_ATOM ||
+           attrib == NODE_GRAPH_ATOM ||
+           attrib == NODE_ATOM ||
+           attrib == NODE_DEF_ATOM ||
+           attrib == NAMESPACE_ATOM;
+}
+
+} // anonymous namespace
+
 //
 // Element methods
 //
@@ -79,22 +105,30 @@ bool Element::operator!=(const Element& rhs) const
     return !(*this == rhs);
 }
 
+void Element::setCategory(const string& category)
+{
+    DocumentPtr doc = getWritableDocument();
+    _category = Atom(category);
+    doc->markModified(this);
+}
+
 void Element::setName(const string& name)
 {
+    DocumentPtr doc = getWritableDocument();
     ElementPtr parent = getParent();
     if (parent && parent->_childMap.count(name) && name != getName())
     {
         throw Exception("Element name is not unique at the given scope: " + name);
     }
 
-    getDocument()->invalidateCache();
-
     if (parent)
     {
         parent->_childMap.erase(getName());
         parent->_childMap[name] = getSelf();
     }
     _name = name;
+
+    doc->markModified(this);
 }
 
 string Element::getNamePath(ConstElementPtr relativeTo) const
@@ -133,15 +167,16 @@ ElementPtr Element::getDescendant(const string& namePath) const
 
 void Element::registerChildElement(ElementPtr child)
 {
-    getDocument()->invalidateCache();
-
+    DocumentPtr doc = getWritableDocument();
     _childMap[child->getName()] = child;
     _childOrder.push_back(child);
+
+    doc->updateCache(child);
 }
 
 void Element::unregisterChildElement(ElementPtr child)
 {
-    getDocument()->invalidateCache();
+    getWritableDocument()->removeFromCache(child);
 
     _childMap.erase(child->getName());
     _childOrder.erase(
@@ -173,6 +208,7 @@ void Element::setChildIndex(const string& name, int index)
         throw Exception("Invalid child index");
     }
 
+    getWritableDocument();
     _childOrder.erase(it);
     _childOrder.insert(_childOrder.begin() + (size_t) index, child);
 }
@@ -188,27 +224,54 @@ void Element::removeChild(const string& name)
     unregisterChildElement(it->second);
 }
 
-void Element::setAttribute(const string& attrib, const string& value)
+void Element::setAttribute(const Atom& atom, string value)
 {
-    getDocument()->invalidateCache();
+    DocumentPtr doc = getWritableDocument();
+    AttributeVec::const_iterator it = findAttribute(atom);
+    if (it != _attributes.end())
+    {
+        _attributes[it - _attributes.begin()].second = std::move(value);
+    }
+    else
+    {
+        // Most elements hold only a few attributes, so allocate room for
+        // them up front rather than growing one attribute at a time.
+        if (_attributes.empty())
+        {
+            _attributes.reserve(INITIAL_ATTRIBUTE_CAPACITY);
+        }
+        _attributes.emplace_back(atom, std::move(value));
+    }
+    attributeChanged(atom);
 
-    if (!_attributeMap.count(attrib))
+    if (isCacheAttribute(atom))
     {
-        _attributeOrder.push_back(attrib);
+        doc->updateCache(getSelf());
+    }
+    else
+    {
+        doc->markModified(this);
     }
-    _attributeMap[attrib] = value;
 }
 
 void Element::removeAttribute(const string& attrib)
 {
-    StringMap::iterator it = _attributeMap.find(attrib);
-    if (it != _attributeMap.end())
+    AttributeVec::const_iterator it = findAttribute(attrib);
+    if (it != _attributes.end())
     {
-        getDocument()->invalidateCache();
+        DocumentPtr doc = getWritableDocument();
+        Atom atom = it->first;
+        _attributes.erase(it);
+        attributeChanged(atom);
 
-        _attributeMap.erase(it);
-        _attributeOrder.erase(
-            std::find(_attributeOrder.begin(), _attributeOrder.end(), attrib));
+        if (isCacheAttribute(atom))
+        {
+            doc->updateCache(getSelf());
+        }
+        else
+        {
+            doc->markModified(this);
+        }
     }
 }
 
@@ -307,6 +370,28 @@ ConstDocumentPtr Element::getDocument() const
     return getRoot()->asA<Document>();
 }
 
+void Element::setSourceUri(const string& sourceUri)
+{
+    getWritableDocument();
+    _sourceUri = sourceUri;
+}
+
+DocumentPtr Element::getWritableDocument()
+{
+    DocumentPtr doc = getDocument();
+    if (doc->isReadOnly())
+    {
+        throw ExceptionReadOnlyDocument("Cannot edit an element of a read-only document: " + getNamePath());
+    }
+    return doc;
+}
+
+ConstElementPtr Element::getDataLibraryRoot(ConstElementPtr root)
+{
+    ConstDocumentPtr doc = root ? root->asA<Document>() : nullptr;
+    return doc ? doc->getDataLibrary() : nullptr;
+}
+
 bool Element::hasInheritedBase(ConstElementPtr base) const
 {
     for (ConstElementPtr elem : traverseInheritance())
@@ -359,11 +444,11 @@ InheritanceIterator Element::traverseInheritance() const
 
 void Element::copyContentFrom(const ConstElementPtr& source)
 {
-    getDocument()->invalidateCache();
-
+    DocumentPtr doc = getWritableDocument();
     _sourceUri = source->_sourceUri;
-    _attributeMap = source->_attributeMap;
-    _attributeOrder = source->_attributeOrder;
+    _attributes = source->_attributes;
+    attributeChanged(Atom());
+    doc->updateCache(getSelf());
 
     for (auto child : source->getChildren())
     {
@@ -384,32 +469,44 @@ void Element::copyContentFrom(const ConstElementPtr& source)
 
 void Element::clearContent()
 {
-    getDocument()->invalidateCache();
+    DocumentPtr doc = getWritableDocument();
+    for (ElementPtr child : _childOrder)
+    {
+        doc->removeFromCache(child);
+    }
 
     _sourceUri.clear();
-    _attributeMap.clear();
-    _attributeOrder.clear();
+    _attributes.clear();
     _childMap.clear();
     _childOrder.clear();
+    attributeChanged(Atom());
+
+    doc->updateCache(getSelf());
 }
 
 bool Element::validate(string* message) const
 {
     bool res = true;
-    validateRequire(isValidName(getName()), res, message, "Invalid element name");
+    validateRequire(isValidName(getName()), res, message, "Invalid element name", "element.name");
     if (hasInheritString())
     {
         bool validInherit = getInheritsFrom() && getInheritsFrom()->getCategory() == getCategory();
-        validateRequire(validInherit, res, message, "Invalid element inheritance");
+        validateRequire(validInherit, res, message, "Invalid element inheritance", "element.inherit");
     }
     for (auto child : getChildren())
     {
         res = child->validate(message) && res;
     }
-    validateRequire(!hasInheritanceCycle(), res, message, "Cycle in element inheritance chain");
+    validateRequire(!hasInheritanceCycle(), res, message, "Cycle in element inheritance chain", "element.inherit.cycle");
     return res;
 }
 
+bool Element::validateWithDiagnostics(ValidationDiagnosticVec& diagnostics) const
+{
+    ValidationDiagnosticScope scope(diagnostics);
+    return validate();
+}
+
 StringResolverPtr Element::createStringResolver(const string& geom) const
 {
     StringResolverPtr resolver = StringResolver::create();
@@ -455,7 +552,7 @@ string Element::asString() const
     return res;
 }
 
-void Element::validateRequire(bool expression, bool& res, string* message, const string& errorDesc) const
+void Element::validateRequire(bool expression, bool& res, string* message, const string& errorDesc, const string& rule) const
 {
     if (!expression)
     {
@@ -464,9 +561,24 @@ void Element::validateRequire(bool expression, bool& res, string* message, const
         {
             *message += errorDesc + ": " + asString() + "\n";
         }
+        if (threadValidationDiagnostics)
+        {
+            threadValidationDiagnostics->push_back({ getNamePath(), rule, errorDesc + ": " + asString() });
+        }
     }
 }
 
+Element::ValidationDiagnosticScope::ValidationDiagnosticScope(ValidationDiagnosticVec& diagnostics) :
+    _previous(threadValidationDiagnostics)
+{
+    threadValidationDiagnostics = &diagnostics;
+}
+
+Element::ValidationDiagnosticScope::~ValidationDiagnosticScope()
+{
+    threadValidationDiagnostics = _previous;
+}
+
 //
 // TypedElement methods
 //
@@ -493,6 +605,39 @@ string ValueElement::getResolvedValueString(StringResolverPtr resolver) const
     return resolver->resolve(getValueString(), getType());
 }
 
+ValuePtr ValueElement::getValue() const
+{
+    // The cache may be read by multiple threads concurrently, so it is
+    // accessed atomically.
+    ValuePtr value = std::atomic_load(&_value);
+    if (!value && hasValue())
+    {
+        value = Value::createValueFromStrings(getValueString(), getType());
+        std::atomic_store(&_value, value);
+    }
+    return value;
+}
+
+ValuePtr ValueElement::getResolvedValue(StringResolverPtr resolver) const
+{
+    if (!hasValue())
+        return ValuePtr();
+    if (!StringResolver::isResolvedType(getType()))
+        return getValue();
+    return Value::createValueFromStrings(getResolvedValueString(resolver), getType());
+}
+
+void ValueElement::attributeChanged(const Atom& attrib)
+{
+    static const Atom VALUE_ATOM(VALUE_ATTRIBUTE);
+    static const Atom TYPE_ATOM(TYPE_ATTRIBUTE);
+
+    if (attrib.empty() || attrib == VALUE_ATOM || attrib == TYPE_ATOM)
+    {
+        std::atomic_store(&_value, ValuePtr());
+    }
+}
+
 ValuePtr ValueElement::getDefaultValue() const
 {
     ConstElementPtr parent = getParent();
@@ -537,29 +682,29 @@ bool ValueElement::validate(string* message) const
     bool res = true;
     if (hasType() && hasValueString())
     {
-        validateRequire(getValue() != nullptr, res, message, "Invalid value");
+        validateRequire(getValue() != nullptr, res, message, "Invalid value", "value.invalid");
     }
 
     if (hasInterfaceName())
     {
-        validateRequire(isA<Input>() || isA<Token>(), res, message, "Only input and token elements support interface names");
+        validateRequire(isA<Input>() || isA<Token>(), res, message, "Only input and token elements support interface names", "value.interfacename.category");
         ConstNodeGraphPtr nodeGraph = getAncestorOfType<NodeGraph>();
         ConstInterfaceElementPtr decl = nodeGraph ? nodeGraph->getDeclaration() : nullptr;
         if (decl)
         {
             ValueElementPtr valueElem = decl->getActiveValueElement(getInterfaceName());
-            validateRequire(valueElem != nullptr, res, message, "Interface name not found in referenced declaration");
+            validateRequire(valueElem != nullptr, res, message, "Interface name not found in referenced declaration", "value.interfacename.missing");
             if (valueElem)
             {
                 ConstPortElementPtr portElem = asA<PortElement>();
                 if (portElem && portElem->hasChannels())
                 {
                     bool valid = portElem->validChannelsString(portElem->getChannels(), valueElem->getType(), getType());
-                    validateRequire(valid, res, message, "Invalid channels string for interface name");
+                    validateRequire(valid, res, message, "Invalid channels string for interface name", "value.interfacename.channels");
                 }
                 else
                 {
-                    validateRequire(getType() == valueElem->getType(), res, message, "Interface name refers to value element of a different type");
+                    validateRequire(getType() == valueElem->getType(), res, message, "Interface name refers to value element of a different type", "value.interfacename.type");
                 }
             }
         }
@@ -572,7 +717,7 @@ bool ValueElement::validate(string* message) const
         if (!unittype.empty())
         {
             unitTypeDef = getDocument()->getUnitTypeDef(unittype);
-            validateRequire(unitTypeDef != nullptr, res, message, "Unit type definition does not exist in document");
+            validateRequire(unitTypeDef != nullptr, res, message, "Unit type definition does not exist in document", "value.unittype.missing");
         }
     }
     if (hasUnit())
@@ -590,7 +735,7 @@ bool ValueElement::validate(string* message) const
                 }
             }
         }
-        validateRequire(foundUnit, res, message, "Unit definition does not exist in document");
+        validateRequire(foundUnit, res, message, "Unit definition does not exist in document", "value.unit.missing");
     }
     return TypedElement::validate(message) && res;
 }
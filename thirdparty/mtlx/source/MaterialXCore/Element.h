@@ -71,6 +71,26 @@ using ElementMap = std::unordered_map<string, ElementPtr>;
 /// A standard function taking an ElementPtr and returning a boolean.
 using ElementPredicate = std::function<bool(ConstElementPtr)>;
 
+/// @struct ValidationDiagnostic
+/// A single requirement of the MaterialX specification that an element
+/// failed to meet during validation.
+struct ValidationDiagnostic
+{
+    /// The name path of the element that failed the requirement.
+    string elementPath;
+
+    /// A stable identifier of the requirement that was not met, such as
+    /// "port.connection.type".  Unlike the message, it does not change with
+    /// the wording of the requirement or the element that failed it.
+    string rule;
+
+    /// The full diagnostic, in the form written by Element::validate.
+    string message;
+};
+
+/// A vector of validation diagnostics
+using ValidationDiagnosticVec = vector<ValidationDiagnostic>;
+
 /// @class Element
 /// The base class for MaterialX elements.
 ///
@@ -111,17 +131,14 @@ class MX_CORE_API Element : public std::enable_shared_from_this<Element>
     /// @{
 
     /// Set the element's category string.
-    void setCategory(const string& category)
-    {
-        _category = category;
-    }
+    void setCategory(const string& category);
 
     /// Return the element's category string.  The category of a MaterialX
     /// element represents its role within the document, with common examples
     /// being "material", "nodegraph", and "image".
     const string& getCategory() const
     {
-        return _category;
+        return _category.str();
     }
 
     /// @}
@@ -161,7 +178,8 @@ class MX_CORE_API Element : public std::enable_shared_from_this<Element>
     /// Set the element's file prefix string.
     void setFilePrefix(const string& prefix)
     {
-        setAttribute(FILE_PREFIX_ATTRIBUTE, prefix);
+        static const Atom FILE_PREFIX_ATOM(FILE_PREFIX_ATTRIBUTE);
+        setAttribute(FILE_PREFIX_ATOM, prefix);
     }
 
     /// Return true if the given element has a file prefix string.
@@ -197,7 +215,8 @@ class MX_CORE_API Element : public std::enable_shared_from_this<Element>
     /// Set the element's geom prefix string.
     void setGeomPrefix(const string& prefix)
     {
-        setAttribute(GEOM_PREFIX_ATTRIBUTE, prefix);
+        static const Atom GEOM_PREFIX_ATOM(GEOM_PREFIX_ATTRIBUTE);
+        setAttribute(GEOM_PREFIX_ATOM, prefix);
     }
 
     /// Return true if the given element has a geom prefix string.
@@ -233,7 +252,8 @@ class MX_CORE_API Element : public std::enable_shared_from_this<Element>
     /// Set the element's color space string.
     void setColorSpace(const string& colorSpace)
     {
-        setAttribute(COLOR_SPACE_ATTRIBUTE, colorSpace);
+        static const Atom COLOR_SPACE_ATOM(COLOR_SPACE_ATTRIBUTE);
+        setAttribute(COLOR_SPACE_ATOM, colorSpace);
     }
 
     /// Return true if the given element has a color space string.
@@ -269,7 +289,8 @@ class MX_CORE_API Element : public std::enable_shared_from_this<Element>
     /// Set the inherit string of this element.
     void setInheritString(const string& inherit)
     {
-        setAttribute(INHERIT_ATTRIBUTE, inherit);
+        static const Atom INHERIT_ATOM(INHERIT_ATTRIBUTE);
+        setAttribute(INHERIT_ATOM, inherit);
     }
 
     /// Return true if this element has an inherit string.
@@ -317,7 +338,8 @@ class MX_CORE_API Element : public std::enable_shared_from_this<Element>
     /// Set the namespace string of this element.
     void setNamespace(const string& space)
     {
-        setAttribute(NAMESPACE_ATTRIBUTE, space);
+        static const Atom NAMESPACE_ATOM(NAMESPACE_ATTRIBUTE);
+        setAttribute(NAMESPACE_ATOM, space);
     }
 
     /// Return true if this element has a namespace string.
@@ -329,7 +351,8 @@ class MX_CORE_API Element : public std::enable_shared_from_this<Element>
     /// Return the namespace string of this element.
     const string& getNamespace() const
     {
-        return getAttribute(NAMESPACE_ATTRIBUTE);
+        static const Atom NAMESPACE_ATOM(NAMESPACE_ATTRIBUTE);
+        return getAttribute(NAMESPACE_ATOM);
     }
 
     /// Return a qualified version of the given name, taking the namespace at the
@@ -362,7 +385,8 @@ class MX_CORE_API Element : public std::enable_shared_from_this<Element>
     /// Set the documentation string of this element.
     void setDocString(const string& doc)
     {
-        setAttribute(DOC_ATTRIBUTE, doc);
+        static const Atom DOC_ATOM(DOC_ATTRIBUTE);
+        setAttribute(DOC_ATOM, doc);
     }
 
     /// Return the documentation string of this element
@@ -418,6 +442,14 @@ class MX_CORE_API Element : public std::enable_shared_from_this<Element>
     /// @return A shared pointer to the new child element.
     ElementPtr addChildOfCategory(const string& category, string name = EMPTY_STRING);
 
+    /// Reserve storage for the given total number of child elements, avoiding
+    /// repeated reallocation when many children are added in sequence.
+    void reserveChildren(size_t count)
+    {
+        _childMap.reserve(count);
+        _childOrder.reserve(count);
+    }
+
     /// Change the category of the given child element.
     /// @param child The child element that will be modified.
     /// @param category The new category string for the child element.
@@ -491,26 +523,55 @@ class MX_CORE_API Element : public std::enable_shared_from_this<Element>
     /// @{
 
     /// Set the value string of the given attribute.
-    void setAttribute(const string& attrib, const string& value);
+    void setAttribute(const string& attrib, string value)
+    {
+        setAttribute(Atom(attrib), std::move(value));
+    }
+
+    /// Set the value string of the given attribute, identifying the
+    /// attribute by atom rather than by string.
+    void setAttribute(const Atom& attrib, string value);
 
     /// Return true if the given attribute is present.
     bool hasAttribute(const string& attrib) const
     {
-        return _attributeMap.count(attrib) != 0;
+        return findAttribute(attrib) != _attributes.end();
+    }
+
+    /// Return true if the given attribute is present, comparing attribute
+    /// names by atom rather than by string.
+    bool hasAttribute(const Atom& attrib) const
+    {
+        return findAttribute(attrib) != _attributes.end();
     }
 
     /// Return the value string of the given attribute.  If the given attribute
     /// is not present, then an empty string is returned.
     const string& getAttribute(const string& attrib) const
     {
-        StringMap::const_iterator it = _attributeMap.find(attrib);
-        return (it != _attributeMap.end()) ? it->second : EMPTY_STRING;
+        AttributeVec::const_iterator it = findAttribute(attrib);
+        return (it != _attributes.end()) ? it->second : EMPTY_STRING;
+    }
+
+    /// Return the value string of the given attribute, comparing attribute
+    /// names by atom rather than by string.  If the given attribute is not
+    /// present, then an empty string is returned.
+    const string& getAttribute(const Atom& attrib) const
+    {
+        AttributeVec::const_iterator it = findAttribute(attrib);
+        return (it != _attributes.end()) ? it->second : EMPTY_STRING;
     }
 
     /// Return a vector of stored attribute names, in the order they were set.
-    const StringVec& getAttributeNames() const
+    StringVec getAttributeNames() const
     {
-        return _attributeOrder;
+        StringVec names;
+        names.reserve(_attributes.size());
+        for (const auto& attr : _attributes)
+        {
+            names.push_back(attr.first.str());
+        }
+        return names;
     }
 
     /// Set the value of an implicitly typed attribute.  Since an attribute
@@ -691,10 +752,7 @@ class MX_CORE_API Element : public std::enable_shared_from_this<Element>
     ///    this element originates.  This string may be used by serialization
     ///    and deserialization routines to maintain hierarchies of include
     ///    references.
-    void setSourceUri(const string& sourceUri)
-    {
-        _sourceUri = sourceUri;
-    }
+    void setSourceUri(const string& sourceUri);
 
     /// Return true if this element has a source URI.
     bool hasSourceUri() const
@@ -730,6 +788,10 @@ class MX_CORE_API Element : public std::enable_shared_from_this<Element>
     /// consistent with the MaterialX specification.
     virtual bool validate(string* message = nullptr) const;
 
+    /// Validate the given element tree as validate does, appending a
+    /// structured diagnostic for each requirement that is not met.
+    bool validateWithDiagnostics(ValidationDiagnosticVec& diagnostics) const;
+
     /// @}
     /// @name Utility
     /// @{
@@ -777,12 +839,48 @@ class MX_CORE_API Element : public std::enable_shared_from_this<Element>
     {
         ConstElementPtr scope = parent ? parent : getRoot();
         shared_ptr<T> child = scope->getChildOfType<T>(getQualifiedName(name));
-        return child ? child : scope->getChildOfType<T>(name);
+        if (!child)
+        {
+            child = scope->getChildOfType<T>(name);
+        }
+        if (!child && !parent)
+        {
+            // Fall back to the data library chain of the root document.
+            for (ConstElementPtr library = getDataLibraryRoot(scope); library && !child; library = getDataLibraryRoot(library))
+            {
+                child = library->getChildOfType<T>(getQualifiedName(name));
+                if (!child)
+                {
+                    child = library->getChildOfType<T>(name);
+                }
+            }
+        }
+        return child;
     }
 
+    // Return the data library, if any, referenced by the given root element.
+    static ConstElementPtr getDataLibraryRoot(ConstElementPtr root);
+
+    // Return the root document of our tree before an edit to this element,
+    // throwing an ExceptionReadOnlyDocument if the document is read-only.
+    DocumentPtr getWritableDocument();
+
     // Enforce a requirement within a validate method, updating the validation
-    // state and optional output text if the requirement is not met.
-    void validateRequire(bool expression, bool& res, string* message, const string& errorDesc) const;
+    // state and optional output text if the requirement is not met.  The rule
+    // identifies the requirement in the diagnostics reported for it.
+    void validateRequire(bool expression, bool& res, string* message, const string& errorDesc, const string& rule) const;
+
+    // Collect the diagnostics reported by validateRequire on the calling
+    // thread into the given vector, for the lifetime of this object.
+    class MX_CORE_API ValidationDiagnosticScope
+    {
+      public:
+        explicit ValidationDiagnosticScope(ValidationDiagnosticVec& diagnostics);
+        ~ValidationDiagnosticScope();
+
+      private:
+        ValidationDiagnosticVec* _previous;
+    };
 
   public:
     static const string NAME_ATTRIBUTE;
@@ -794,9 +892,23 @@ class MX_CORE_API Element : public std::enable_shared_from_this<Element>
     static const string DOC_ATTRIBUTE;
 
   protected:
+    // Attribute names and values, in the order they were set.  Elements hold
+    // few attributes, so a linear search outperforms a hash map here.
+    using AttributeVec = vector<std::pair<Atom, string>>;
+
+    template <class T> AttributeVec::const_iterator findAttribute(const T& attrib) const
+    {
+        return std::find_if(_attributes.begin(), _attributes.end(),
+                            [&attrib](const AttributeVec::value_type& attr) { return attr.first == attrib; });
+    }
+
     virtual void registerChildElement(ElementPtr child);
     virtual void unregisterChildElement(ElementPtr child);
 
+    // Called after the given attribute of this element has been set or
+    // removed.  An empty atom indicates that any attribute may have changed.
+    virtual void attributeChanged(const Atom&) { }
+
     // Return a non-const copy of our self pointer, for use in constructing
     // graph traversal objects that require non-const storage.
     ElementPtr getSelfNonConst() const
@@ -805,15 +917,14 @@ class MX_CORE_API Element : public std::enable_shared_from_this<Element>
     }
 
   protected:
-    string _category;
+    Atom _category;
     string _name;
     string _sourceUri;
 
     ElementMap _childMap;
     vector<ElementPtr> _childOrder;
 
-    StringMap _attributeMap;
-    StringVec _attributeOrder;
+    AttributeVec _attributes;
 
     weak_ptr<Element> _parent;
     weak_ptr<Element> _root;
@@ -854,7 +965,8 @@ class MX_CORE_API TypedElement : public Element
     /// Set the element's type string.
     void setType(const string& type)
     {
-        setAttribute(TYPE_ATTRIBUTE, type);
+        static const Atom TYPE_ATOM(TYPE_ATTRIBUTE);
+        setAttribute(TYPE_ATOM, type);
     }
 
     /// Return true if the given element has a type string.
@@ -914,7 +1026,8 @@ class MX_CORE_API ValueElement : public TypedElement
     /// Set the value string of an element.
     void setValueString(const string& value)
     {
-        setAttribute(VALUE_ATTRIBUTE, value);
+        static const Atom VALUE_ATOM(VALUE_ATTRIBUTE);
+        setAttribute(VALUE_ATOM, value);
     }
 
     /// Return true if the given element has a value string.
@@ -943,7 +1056,8 @@ class MX_CORE_API ValueElement : public TypedElement
     /// Set the interface name of an element.
     void setInterfaceName(const string& name)
     {
-        setAttribute(INTERFACE_NAME_ATTRIBUTE, name);
+        static const Atom INTERFACE_NAME_ATOM(INTERFACE_NAME_ATTRIBUTE);
+        setAttribute(INTERFACE_NAME_ATOM, name);
     }
 
     /// Return true if the given element has an interface name.
@@ -965,7 +1079,8 @@ class MX_CORE_API ValueElement : public TypedElement
     /// Set the implementation name of an element.
     void setImplementationName(const string& name)
     {
-        setAttribute(IMPLEMENTATION_NAME_ATTRIBUTE, name);
+        static const Atom IMPLEMENTATION_NAME_ATOM(IMPLEMENTATION_NAME_ATTRIBUTE);
+        setAttribute(IMPLEMENTATION_NAME_ATOM, name);
     }
 
     /// Return true if the given element has an implementation name.
@@ -1004,16 +1119,13 @@ class MX_CORE_API ValueElement : public TypedElement
     }
 
     /// Return the typed value of an element as a generic value object, which
-    /// may be queried to access its data.
+    /// may be queried to access its data.  The parsed value is cached until
+    /// the value or type string of the element changes, and the returned
+    /// object is shared between callers, so it should not be modified.
     ///
     /// @return A shared pointer to the typed value of this element, or an
     ///    empty shared pointer if no value is present.
-    ValuePtr getValue() const
-    {
-        if (!hasValue())
-            return ValuePtr();
-        return Value::createValueFromStrings(getValueString(), getType());
-    }
+    ValuePtr getValue() const;
 
     /// Return the resolved value of an element as a generic value object, which
     /// may be queried to access its data.
@@ -1023,12 +1135,7 @@ class MX_CORE_API ValueElement : public TypedElement
     ///    will be created at this scope and applied to the return value.
     /// @return A shared pointer to the typed value of this element, or an
     ///    empty shared pointer if no value is present.
-    ValuePtr getResolvedValue(StringResolverPtr resolver = nullptr) const
-    {
-        if (!hasValue())
-            return ValuePtr();
-        return Value::createValueFromStrings(getResolvedValueString(resolver), getType());
-    }
+    ValuePtr getResolvedValue(StringResolverPtr resolver = nullptr) const;
 
     /// Return the default value for this element as a generic value object, which
     /// may be queried to access its data.
@@ -1044,7 +1151,8 @@ class MX_CORE_API ValueElement : public TypedElement
     /// Set the unit string of an element.
     void setUnit(const string& unit)
     {
-        setAttribute(UNIT_ATTRIBUTE, unit);
+        static const Atom UNIT_ATOM(UNIT_ATTRIBUTE);
+        setAttribute(UNIT_ATOM, unit);
     }
 
     /// Return true if the given element has a unit string.
@@ -1066,7 +1174,8 @@ class MX_CORE_API ValueElement : public TypedElement
     /// Set the unit type of an element.
     void setUnitType(const string& unit)
     {
-        setAttribute(UNITTYPE_ATTRIBUTE, unit);
+        static const Atom UNITTYPE_ATOM(UNITTYPE_ATTRIBUTE);
+        setAttribute(UNITTYPE_ATOM, unit);
     }
 
     /// Return true if the given element has a unit type.
@@ -1125,6 +1234,12 @@ class MX_CORE_API ValueElement : public TypedElement
     static const string UNIT_ATTRIBUTE;
     static const string UNITTYPE_ATTRIBUTE;
     static const string UNIFORM_ATTRIBUTE;
+
+  protected:
+    void attributeChanged(const Atom& attrib) override;
+
+  private:
+    mutable ValuePtr _value;
 };
 
 /// @class Token
@@ -1328,6 +1443,15 @@ class MX_CORE_API ExceptionOrphanedElement : public Exception
     using Exception::Exception;
 };
 
+/// @class ExceptionReadOnlyDocument
+/// An exception that is thrown when an element of a read-only Document
+/// is edited.
+class MX_CORE_API ExceptionReadOnlyDocument : public Exception
+{
+  public:
+    using Exception::Exception;
+};
+
 template <class T> shared_ptr<T> Element::addChild(const string& name)
 {
     string childName = name;
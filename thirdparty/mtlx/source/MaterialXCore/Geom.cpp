@@ -71,7 +71,7 @@ bool GeomElement::validate(string* message) const
     bool res = true;
     if (hasCollectionString())
     {
-        validateRequire(getCollection() != nullptr, res, message, "Invalid collection string");
+        validateRequire(getCollection() != nullptr, res, message, "Invalid collection string", "geom.collection.missing");
     }
     return Element::validate(message) && res;
 }
@@ -174,7 +174,7 @@ bool Collection::matchesGeomString(const string& geom) const
 bool Collection::validate(string* message) const
 {
     bool res = true;
-    validateRequire(!hasIncludeCycle(), res, message, "Cycle in collection include chain");
+    validateRequire(!hasIncludeCycle(), res, message, "Cycle in collection include chain", "collection.include.cycle");
     return Element::validate(message) && res;
 }
 
@@ -157,7 +157,8 @@ class MX_CORE_API GeomElement : public Element
     /// Set the geometry string of this element.
     void setGeom(const string& geom)
     {
-        setAttribute(GEOM_ATTRIBUTE, geom);
+        static const Atom GEOM_ATOM(GEOM_ATTRIBUTE);
+        setAttribute(GEOM_ATOM, geom);
     }
 
     /// Return true if this element has a geometry string.
@@ -188,7 +189,8 @@ class MX_CORE_API GeomElement : public Element
     /// Set the collection string of this element.
     void setCollectionString(const string& collection)
     {
-        setAttribute(COLLECTION_ATTRIBUTE, collection);
+        static const Atom COLLECTION_ATOM(COLLECTION_ATTRIBUTE);
+        setAttribute(COLLECTION_ATOM, collection);
     }
 
     /// Return true if this element has a collection string.
@@ -363,7 +365,8 @@ class MX_CORE_API GeomPropDef : public TypedElement
     /// Set the geometric property string of this element.
     void setGeomProp(const string& node)
     {
-        setAttribute(GEOM_PROP_ATTRIBUTE, node);
+        static const Atom GEOM_PROP_ATOM(GEOM_PROP_ATTRIBUTE);
+        setAttribute(GEOM_PROP_ATOM, node);
     }
 
     /// Return true if this element has a geometric property string.
@@ -385,7 +388,8 @@ class MX_CORE_API GeomPropDef : public TypedElement
     /// Set the geometric space string of this element.
     void setSpace(const string& space)
     {
-        setAttribute(SPACE_ATTRIBUTE, space);
+        static const Atom SPACE_ATOM(SPACE_ATTRIBUTE);
+        setAttribute(SPACE_ATOM, space);
     }
 
     /// Return true if this element has a geometric space string.
@@ -407,7 +411,8 @@ class MX_CORE_API GeomPropDef : public TypedElement
     /// Set the index string of this element.
     void setIndex(const string& space)
     {
-        setAttribute(INDEX_ATTRIBUTE, space);
+        static const Atom INDEX_ATOM(INDEX_ATTRIBUTE);
+        setAttribute(INDEX_ATOM, space);
     }
 
     /// Return true if this element has an index string.
@@ -448,7 +453,8 @@ class MX_CORE_API Collection : public Element
     /// Set the include geometry string of this element.
     void setIncludeGeom(const string& geom)
     {
-        setAttribute(INCLUDE_GEOM_ATTRIBUTE, geom);
+        static const Atom INCLUDE_GEOM_ATOM(INCLUDE_GEOM_ATTRIBUTE);
+        setAttribute(INCLUDE_GEOM_ATOM, geom);
     }
 
     /// Return true if this element has an include geometry string.
@@ -479,7 +485,8 @@ class MX_CORE_API Collection : public Element
     /// Set the exclude geometry string of this element.
     void setExcludeGeom(const string& geom)
     {
-        setAttribute(EXCLUDE_GEOM_ATTRIBUTE, geom);
+        static const Atom EXCLUDE_GEOM_ATOM(EXCLUDE_GEOM_ATTRIBUTE);
+        setAttribute(EXCLUDE_GEOM_ATOM, geom);
     }
 
     /// Return true if this element has an exclude geometry string.
@@ -510,7 +517,8 @@ class MX_CORE_API Collection : public Element
     /// Set the include collection string of this element.
     void setIncludeCollectionString(const string& collection)
     {
-        setAttribute(INCLUDE_COLLECTION_ATTRIBUTE, collection);
+        static const Atom INCLUDE_COLLECTION_ATOM(INCLUDE_COLLECTION_ATTRIBUTE);
+        setAttribute(INCLUDE_COLLECTION_ATOM, collection);
     }
 
     /// Return true if this element has an include collection string.
@@ -167,7 +167,7 @@ bool PortElement::validate(string* message) const
         NodeGraphPtr nodeGraph = resolveNameReference<NodeGraph>(getNodeName());
         if (!nodeGraph)
         {
-            validateRequire(connectedNode != nullptr, res, message, "Invalid port connection");
+            validateRequire(connectedNode != nullptr, res, message, "Invalid port connection", "port.connection.missing");
         }
     }
     if (connectedNode)
@@ -183,7 +183,7 @@ bool PortElement::validate(string* message) const
                 if (output)
                 {
                     validateRequire(connectedNode->getType() == MULTI_OUTPUT_TYPE_STRING, res, message,
-                                    "Multi-output type expected in port connection");
+                                    "Multi-output type expected in port connection", "port.connection.multioutput");
                 }
             }
             else if (hasNodeGraphString())
@@ -195,7 +195,7 @@ bool PortElement::validate(string* message) const
                     if (nodeGraph->getNodeDef())
                     {
                         validateRequire(nodeGraph->getOutputCount() > 1, res, message,
-                                        "Multi-output type expected in port connection");
+                                        "Multi-output type expected in port connection", "port.connection.multioutput");
                     }
                 }
             }
@@ -204,29 +204,29 @@ bool PortElement::validate(string* message) const
                 // Document has no concept of a multioutput type
                 output = getDocument()->getOutput(outputString);
             }
-            validateRequire(output != nullptr, res, message, "No output found for port connection");
+            validateRequire(output != nullptr, res, message, "No output found for port connection", "port.connection.output");
 
             if (output)
             {
                 if (hasChannels())
                 {
                     bool valid = validChannelsString(getChannels(), output->getType(), getType());
-                    validateRequire(valid, res, message, "Invalid channels string in port connection");
+                    validateRequire(valid, res, message, "Invalid channels string in port connection", "port.connection.channels");
                 }
                 else
                 {
-                    validateRequire(getType() == output->getType(), res, message, "Mismatched types in port connection");
+                    validateRequire(getType() == output->getType(), res, message, "Mismatched types in port connection", "port.connection.type");
                 }
             }
         }
         else if (hasChannels())
         {
             bool valid = validChannelsString(getChannels(), connectedNode->getType(), getType());
-            validateRequire(valid, res, message, "Invalid channels string in port connection");
+            validateRequire(valid, res, message, "Invalid channels string in port connection", "port.connection.channels");
         }
         else if (connectedNode->getType() != MULTI_OUTPUT_TYPE_STRING)
         {
-            validateRequire(getType() == connectedNode->getType(), res, message, "Mismatched types in port connection");
+            validateRequire(getType() == connectedNode->getType(), res, message, "Mismatched types in port connection", "port.connection.type");
         }
     }
     return ValueElement::validate(message) && res;
@@ -332,18 +332,18 @@ bool Input::validate(string* message) const
 
     if (hasDefaultGeomPropString())
     {
-        validateRequire(parent->isA<NodeDef>(), res, message, "Invalid defaultgeomprop on non-definition input");
-        validateRequire(getDefaultGeomProp() != nullptr, res, message, "Invalid defaultgeomprop string");
+        validateRequire(parent->isA<NodeDef>(), res, message, "Invalid defaultgeomprop on non-definition input", "input.defaultgeomprop.parent");
+        validateRequire(getDefaultGeomProp() != nullptr, res, message, "Invalid defaultgeomprop string", "input.defaultgeomprop.missing");
     }
     if (parent->isA<Node>())
     {
         bool hasValueBinding = hasValue();
         bool hasConnection = hasNodeName() || hasNodeGraphString() || hasOutputString() || hasInterfaceName();
-        validateRequire(hasValueBinding || hasConnection, res, message, "Node input binds no value or connection");
+        validateRequire(hasValueBinding || hasConnection, res, message, "Node input binds no value or connection", "input.binding");
     }
     else if (parent->isA<NodeGraph>())
     {
-        validateRequire(parent->asA<NodeGraph>()->getNodeDef() == nullptr, res, message, "Input element in a functional nodegraph has no effect");
+        validateRequire(parent->asA<NodeGraph>()->getNodeDef() == nullptr, res, message, "Input element in a functional nodegraph has no effect", "input.functionalgraph");
     }
     return PortElement::validate(message) && res;
 }
@@ -378,7 +378,7 @@ bool Output::hasUpstreamCycle() const
 bool Output::validate(string* message) const
 {
     bool res = true;
-    validateRequire(!hasUpstreamCycle(), res, message, "Cycle in upstream path");
+    validateRequire(!hasUpstreamCycle(), res, message, "Cycle in upstream path", "output.upstream.cycle");
     return PortElement::validate(message) && res;
 }
 
@@ -71,7 +71,8 @@ class MX_CORE_API PortElement : public ValueElement
     /// the Node with the given name within the same NodeGraph.
     void setNodeName(const string& node)
     {
-        setAttribute(NODE_NAME_ATTRIBUTE, node);
+        static const Atom NODE_NAME_ATOM(NODE_NAME_ATTRIBUTE);
+        setAttribute(NODE_NAME_ATOM, node);
     }
 
     /// Return true if this element has a node name string.
@@ -93,7 +94,8 @@ class MX_CORE_API PortElement : public ValueElement
     /// Set the node graph string of this element.
     void setNodeGraphString(const string& node)
     {
-        setAttribute(NODE_GRAPH_ATTRIBUTE, node);
+        static const Atom NODE_GRAPH_ATOM(NODE_GRAPH_ATTRIBUTE);
+        setAttribute(NODE_GRAPH_ATOM, node);
     }
 
     /// Return true if this element has a node graph string.
@@ -115,7 +117,8 @@ class MX_CORE_API PortElement : public ValueElement
     /// Set the output string of this element.
     void setOutputString(const string& output)
     {
-        setAttribute(OUTPUT_ATTRIBUTE, output);
+        static const Atom OUTPUT_ATOM(OUTPUT_ATTRIBUTE);
+        setAttribute(OUTPUT_ATOM, output);
     }
 
     /// Return true if this element has an output string.
@@ -145,7 +148,8 @@ class MX_CORE_API PortElement : public ValueElement
     /// that will be applied to the upstream result if this port is connected.
     void setChannels(const string& channels)
     {
-        setAttribute(CHANNELS_ATTRIBUTE, channels);
+        static const Atom CHANNELS_ATOM(CHANNELS_ATTRIBUTE);
+        setAttribute(CHANNELS_ATOM, channels);
     }
 
     /// Return true if this element has a channels string.
@@ -222,7 +226,8 @@ class MX_CORE_API Input : public PortElement
     /// Set the defaultgeomprop string for the input.
     void setDefaultGeomPropString(const string& geomprop)
     {
-        setAttribute(DEFAULT_GEOM_PROP_ATTRIBUTE, geomprop);
+        static const Atom DEFAULT_GEOM_PROP_ATOM(DEFAULT_GEOM_PROP_ATTRIBUTE);
+        setAttribute(DEFAULT_GEOM_PROP_ATOM, geomprop);
     }
 
     /// Return true if the given input has a defaultgeomprop string.
@@ -338,7 +343,8 @@ class MX_CORE_API InterfaceElement : public TypedElement
     /// Set the NodeDef string for the interface.
     void setNodeDefString(const string& nodeDef)
     {
-        setAttribute(NODE_DEF_ATTRIBUTE, nodeDef);
+        static const Atom NODE_DEF_ATOM(NODE_DEF_ATTRIBUTE);
+        setAttribute(NODE_DEF_ATOM, nodeDef);
     }
 
     /// Return true if the given interface has a NodeDef string.
@@ -568,7 +574,8 @@ class MX_CORE_API InterfaceElement : public TypedElement
     /// Set the target string of this interface.
     void setTarget(const string& target)
     {
-        setAttribute(TARGET_ATTRIBUTE, target);
+        static const Atom TARGET_ATOM(TARGET_ATTRIBUTE);
+        setAttribute(TARGET_ATOM, target);
     }
 
     /// Return true if the given interface has a target string.
@@ -590,7 +597,8 @@ class MX_CORE_API InterfaceElement : public TypedElement
     /// Set the version string of this interface.
     void setVersionString(const string& version)
     {
-        setAttribute(VERSION_ATTRIBUTE, version);
+        static const Atom VERSION_ATOM(VERSION_ATTRIBUTE);
+        setAttribute(VERSION_ATOM, version);
     }
 
     /// Return true if this interface has a version string.
@@ -253,7 +253,8 @@ class MX_CORE_API LookGroup : public Element
     /// Set comma-separated list of looks.
     void setLooks(const string& looks)
     {
-        setAttribute(LOOKS_ATTRIBUTE, looks);
+        static const Atom LOOKS_ATOM(LOOKS_ATTRIBUTE);
+        setAttribute(LOOKS_ATOM, looks);
     }
 
     /// Get comma-separated list of looks.
@@ -265,7 +266,8 @@ class MX_CORE_API LookGroup : public Element
     /// Set the active look.
     void setActiveLook(const string& look)
     {
-        setAttribute(ACTIVE_ATTRIBUTE, look);
+        static const Atom ACTIVE_ATOM(ACTIVE_ATTRIBUTE);
+        setAttribute(ACTIVE_ATOM, look);
     }
 
     /// Return the active look, if any.
@@ -297,7 +299,8 @@ class MX_CORE_API MaterialAssign : public GeomElement
     /// Set the material string for the MaterialAssign.
     void setMaterial(const string& material)
     {
-        setAttribute(MATERIAL_ATTRIBUTE, material);
+        static const Atom MATERIAL_ATOM(MATERIAL_ATTRIBUTE);
+        setAttribute(MATERIAL_ATOM, material);
     }
 
     /// Return true if the given MaterialAssign has a material string.
@@ -403,7 +406,8 @@ class MX_CORE_API Visibility : public GeomElement
     /// Set the viewer geom string of the element.
     void setViewerGeom(const string& geom)
     {
-        setAttribute(VIEWER_GEOM_ATTRIBUTE, geom);
+        static const Atom VIEWER_GEOM_ATOM(VIEWER_GEOM_ATTRIBUTE);
+        setAttribute(VIEWER_GEOM_ATOM, geom);
     }
 
     /// Return true if the given element has a viewer geom string.
@@ -425,7 +429,8 @@ class MX_CORE_API Visibility : public GeomElement
     /// Set the viewer geom string of the element.
     void setViewerCollection(const string& collection)
     {
-        setAttribute(VIEWER_COLLECTION_ATTRIBUTE, collection);
+        static const Atom VIEWER_COLLECTION_ATOM(VIEWER_COLLECTION_ATTRIBUTE);
+        setAttribute(VIEWER_COLLECTION_ATOM, collection);
     }
 
     /// Return true if the given element has a viewer collection string.
@@ -447,7 +452,8 @@ class MX_CORE_API Visibility : public GeomElement
     /// Set the visibility type string of the element.
     void setVisibilityType(const string& type)
     {
-        setAttribute(VISIBILITY_TYPE_ATTRIBUTE, type);
+        static const Atom VISIBILITY_TYPE_ATOM(VISIBILITY_TYPE_ATTRIBUTE);
+        setAttribute(VISIBILITY_TYPE_ATOM, type);
     }
 
     /// Return true if the given element has a visibility type string.
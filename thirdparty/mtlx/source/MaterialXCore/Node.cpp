@@ -92,12 +92,61 @@ OutputPtr Node::getConnectedOutput(const string& inputName) const
     return input->getConnectedOutput();
 }
 
+struct Node::NodeDefCache
+{
+    struct Entry
+    {
+        string target;
+        bool allowRoughMatch;
+        NodeDefPtr nodeDef;
+    };
+
+    size_t epoch;
+    vector<Entry> entries;
+};
+
 NodeDefPtr Node::getNodeDef(const string& target, bool allowRoughMatch) const
 {
     if (hasNodeDefString())
     {
         return resolveNameReference<NodeDef>(getNodeDefString());
     }
+
+    // Resolutions are cached per node until the document, or any of its data
+    // libraries, is next edited.  The cache may be read by multiple threads
+    // concurrently, so it is replaced atomically rather than modified.
+    ConstDocumentPtr doc = getDocument();
+    const size_t epoch = doc->getModificationEpoch();
+    shared_ptr<const NodeDefCache> cache = std::atomic_load(&_nodeDefCache);
+    if (cache && cache->epoch == epoch)
+    {
+        for (const NodeDefCache::Entry& entry : cache->entries)
+        {
+            if (entry.target == target && entry.allowRoughMatch == allowRoughMatch)
+            {
+                doc->_nodeDefCacheHits++;
+                return entry.nodeDef;
+            }
+        }
+    }
+    doc->_nodeDefCacheMisses++;
+
+    NodeDefPtr nodeDef = resolveNodeDef(target, allowRoughMatch);
+
+    shared_ptr<NodeDefCache> newCache = std::make_shared<NodeDefCache>();
+    newCache->epoch = epoch;
+    if (cache && cache->epoch == epoch)
+    {
+        newCache->entries = cache->entries;
+    }
+    newCache->entries.push_back({ target, allowRoughMatch, nodeDef });
+    std::atomic_store(&_nodeDefCache, shared_ptr<const NodeDefCache>(newCache));
+
+    return nodeDef;
+}
+
+NodeDefPtr Node::resolveNodeDef(const string& target, bool allowRoughMatch) const
+{
     vector<NodeDefPtr> nodeDefs = getDocument()->getMatchingNodeDefs(getQualifiedName(getCategory()));
     vector<NodeDefPtr> secondary = getDocument()->getMatchingNodeDefs(getCategory());
     vector<NodeDefPtr> roughMatches;
@@ -214,20 +263,20 @@ vector<PortElementPtr> Node::getDownstreamPorts() const
 bool Node::validate(string* message) const
 {
     bool res = true;
-    validateRequire(!getCategory().empty(), res, message, "Node element is missing a category");
-    validateRequire(hasType(), res, message, "Node element is missing a type");
+    validateRequire(!getCategory().empty(), res, message, "Node element is missing a category", "node.category");
+    validateRequire(hasType(), res, message, "Node element is missing a type", "node.type");
 
     NodeDefPtr nodeDef = getNodeDef(EMPTY_STRING, true);
     if (nodeDef)
     {
         string matchMessage;
         bool exactMatch = hasExactInputMatch(nodeDef, &matchMessage);
-        validateRequire(exactMatch, res, message, "Node interface error: " + matchMessage);
+        validateRequire(exactMatch, res, message, "Node interface error: " + matchMessage, "node.interface");
     }
     else
     {
         bool categoryDeclared = !getDocument()->getMatchingNodeDefs(getCategory()).empty();
-        validateRequire(!categoryDeclared, res, message, "Node interface doesn't support this output type");
+        validateRequire(!categoryDeclared, res, message, "Node interface doesn't support this output type", "node.output.type");
     }
 
     return InterfaceElement::validate(message) && res;
@@ -708,7 +757,8 @@ void NodeGraph::modifyInterfaceName(const string& inputPath, const string& inter
 NodeDefPtr NodeGraph::getNodeDef() const
 {
     NodeDefPtr nodedef = resolveNameReference<NodeDef>(getNodeDefString());
-    // If not directly defined look for an implementation which has a nodedef association
+    // If not directly defined look for an implementation which has a nodedef association,
+    // preferring those of the document over those of its data library.
     if (!nodedef)
     {
         for (auto impl : getDocument()->getImplementations())
@@ -716,6 +766,7 @@ NodeDefPtr NodeGraph::getNodeDef() const
             if (impl->getNodeGraph() == getQualifiedName(getName()))
             {
                 nodedef = impl->getNodeDef();
+                break;
             }
         }
     }
@@ -751,19 +802,19 @@ bool NodeGraph::validate(string* message) const
 {
     bool res = true;
 
-    validateRequire(!hasVersionString(), res, message, "NodeGraph elements do not support version strings");
+    validateRequire(!hasVersionString(), res, message, "NodeGraph elements do not support version strings", "nodegraph.version");
     if (hasNodeDefString())
     {
         NodeDefPtr nodeDef = getNodeDef();
-        validateRequire(nodeDef != nullptr, res, message, "NodeGraph implementation refers to non-existent NodeDef");
+        validateRequire(nodeDef != nullptr, res, message, "NodeGraph implementation refers to non-existent NodeDef", "nodegraph.nodedef.missing");
         if (nodeDef)
         {
             vector<OutputPtr> graphOutputs = getOutputs();
             vector<OutputPtr> nodeDefOutputs = nodeDef->getActiveOutputs();
-            validateRequire(graphOutputs.size() == nodeDefOutputs.size(), res, message, "NodeGraph implementation has a different number of outputs than its NodeDef");
+            validateRequire(graphOutputs.size() == nodeDefOutputs.size(), res, message, "NodeGraph implementation has a different number of outputs than its NodeDef", "nodegraph.output.count");
             if (graphOutputs.size() == 1 && nodeDefOutputs.size() == 1)
             {
-                validateRequire(graphOutputs[0]->getType() == nodeDefOutputs[0]->getType(), res, message, "NodeGraph implementation has a different output type than its NodeDef");
+                validateRequire(graphOutputs[0]->getType() == nodeDefOutputs[0]->getType(), res, message, "NodeGraph implementation has a different output type than its NodeDef", "nodegraph.output.type");
             }
         }
     }
@@ -831,7 +882,7 @@ bool Backdrop::validate(string* message) const
     {
         StringVec stringVec = getTypedAttribute<StringVec>("contains");
         vector<TypedElementPtr> elemVec = getContainsElements();
-        validateRequire(stringVec.size() == elemVec.size(), res, message, "Invalid element in contains string");
+        validateRequire(stringVec.size() == elemVec.size(), res, message, "Invalid element in contains string", "backdrop.contains");
     }
     return Element::validate(message) && res;
 }
@@ -175,6 +175,14 @@ class MX_CORE_API Node : public InterfaceElement
 
   public:
     static const string CATEGORY;
+
+  private:
+    NodeDefPtr resolveNodeDef(const string& target, bool allowRoughMatch) const;
+
+  private:
+    // Nodedef resolutions for this node, valid at a single document epoch.
+    struct NodeDefCache;
+    mutable shared_ptr<const NodeDefCache> _nodeDefCache;
 };
 
 /// @class GraphElement
@@ -418,7 +426,8 @@ class MX_CORE_API Backdrop : public Element
     /// Set the contains string for this backdrop.
     void setContainsString(const string& contains)
     {
-        setAttribute(CONTAINS_ATTRIBUTE, contains);
+        static const Atom CONTAINS_ATOM(CONTAINS_ATTRIBUTE);
+        setAttribute(CONTAINS_ATOM, contains);
     }
 
     /// Return true if this backdrop has a contains string.
@@ -72,7 +72,8 @@ class MX_CORE_API PropertyAssign : public ValueElement
     /// Set the property string of this element.
     void setProperty(const string& property)
     {
-        setAttribute(PROPERTY_ATTRIBUTE, property);
+        static const Atom PROPERTY_ATOM(PROPERTY_ATTRIBUTE);
+        setAttribute(PROPERTY_ATOM, property);
     }
 
     /// Return true if this element has a property string.
@@ -94,7 +95,8 @@ class MX_CORE_API PropertyAssign : public ValueElement
     /// Set the geometry string of this element.
     void setGeom(const string& geom)
     {
-        setAttribute(GEOM_ATTRIBUTE, geom);
+        static const Atom GEOM_ATOM(GEOM_ATTRIBUTE);
+        setAttribute(GEOM_ATOM, geom);
     }
 
     /// Return true if this element has a geometry string.
@@ -116,7 +118,8 @@ class MX_CORE_API PropertyAssign : public ValueElement
     /// Set the collection string of this element.
     void setCollectionString(const string& collection)
     {
-        setAttribute(COLLECTION_ATTRIBUTE, collection);
+        static const Atom COLLECTION_ATOM(COLLECTION_ATTRIBUTE);
+        setAttribute(COLLECTION_ATOM, collection);
     }
 
     /// Return true if this element has a collection string.
@@ -238,7 +241,8 @@ class MX_CORE_API PropertySetAssign : public GeomElement
     /// Set the property set string of this element.
     void setPropertySetString(const string& propertySet)
     {
-        setAttribute(PROPERTY_SET_ATTRIBUTE, propertySet);
+        static const Atom PROPERTY_SET_ATOM(PROPERTY_SET_ATTRIBUTE);
+        setAttribute(PROPERTY_SET_ATOM, propertySet);
     }
 
     /// Return true if this element has a property set string.
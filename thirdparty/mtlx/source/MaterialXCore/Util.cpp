@@ -5,6 +5,7 @@
 
 #include <MaterialXCore/Types.h>
 
+#include <atomic>
 #include <cctype>
 
 MATERIALX_NAMESPACE_BEGIN
@@ -22,6 +23,66 @@ const std::tuple<int, int, int> LIBRARY_VERSION_TUPLE(MATERIALX_MAJOR_VERSION,
                                                       MATERIALX_MINOR_VERSION,
                                                       MATERIALX_BUILD_VERSION);
 
+// The global symbol table for interned atoms.  Strings are never removed,
+// so the addresses of stored strings remain valid for the process lifetime.
+// Each bucket is a singly linked list that only ever grows at its head, so
+// lookups never block, and a new string is published with a single
+// compare-and-swap.
+class AtomTable
+{
+  public:
+    static const string* intern(const string& str)
+    {
+        const size_t hash = std::hash<string>{}(str);
+        std::atomic<Entry*>& bucket = _buckets[hash & (BUCKET_COUNT - 1)];
+        Entry* head = bucket.load(std::memory_order_acquire);
+        if (const string* found = find(head, nullptr, hash, str))
+        {
+            return found;
+        }
+
+        Entry* entry = new Entry{ str, hash, head };
+        while (!bucket.compare_exchange_weak(entry->next, entry, std::memory_order_release, std::memory_order_acquire))
+        {
+            // Only entries added since the last attempt need to be checked.
+            if (const string* found = find(entry->next, head, hash, str))
+            {
+                delete entry;
+                return found;
+            }
+            head = entry->next;
+        }
+        return &entry->str;
+    }
+
+  private:
+    struct Entry
+    {
+        string str;
+        size_t hash;
+        Entry* next;
+    };
+
+    static const string* find(Entry* first, Entry* last, size_t hash, const string& str)
+    {
+        for (Entry* entry = first; entry != last; entry = entry->next)
+        {
+            if (entry->hash == hash && entry->str == str)
+            {
+                return &entry->str;
+            }
+        }
+        return nullptr;
+    }
+
+    static const size_t BUCKET_COUNT = 4096;
+    static std::atomic<Entry*> _buckets[BUCKET_COUNT];
+};
+
+// Zero-initialized before any dynamic initialization, so atoms may be
+// interned from static initializers in other translation units.
+std::atomic<AtomTable::Entry*> AtomTable::_buckets[AtomTable::BUCKET_COUNT];
+
 bool invalidNameChar(char c)
 {
     return !isalnum((unsigned char) c) && c != '_' && c != ':';
@@ -179,4 +240,13 @@ string parentNamePath(const string& namePath)
     return EMPTY_STRING;
 }
 
+//
+// Atom methods
+//
+
+Atom::Atom(const string& str) :
+    _str(str.empty() ? nullptr : AtomTable::intern(str))
+{
+}
+
 MATERIALX_NAMESPACE_END
@@ -69,6 +69,63 @@ MX_CORE_API string createNamePath(const StringVec& nameVec);
 /// Given a name path, return the parent name path
 MX_CORE_API string parentNamePath(const string& namePath);
 
+/// @class Atom
+/// An interned string, stored once in a global symbol table for the lifetime
+/// of the process.  Atoms constructed from equal strings share storage, so
+/// comparisons between atoms reduce to a pointer compare.
+class MX_CORE_API Atom
+{
+  public:
+    /// Construct the empty atom.
+    Atom() :
+        _str(nullptr)
+    {
+    }
+
+    /// Construct the atom for the given string, adding it to the symbol
+    /// table if not already present.
+    explicit Atom(const string& str);
+
+    /// Return the string value of this atom.
+    const string& str() const
+    {
+        return _str ? *_str : EMPTY_STRING;
+    }
+
+    /// Return true if this is the empty atom.
+    bool empty() const
+    {
+        return _str == nullptr;
+    }
+
+    /// Return true if the given atom is identical to this one.
+    bool operator==(const Atom& rhs) const
+    {
+        return _str == rhs._str;
+    }
+
+    /// Return true if the given atom differs from this one.
+    bool operator!=(const Atom& rhs) const
+    {
+        return _str != rhs._str;
+    }
+
+    /// Return true if the given string is equal to the value of this atom.
+    bool operator==(const string& rhs) const
+    {
+        return str() == rhs;
+    }
+
+    /// Return true if the given string differs from the value of this atom.
+    bool operator!=(const string& rhs) const
+    {
+        return str() != rhs;
+    }
+
+  private:
+    const string* _str;
+};
+
 MATERIALX_NAMESPACE_END
 
 #endif
@@ -5,19 +5,24 @@
 
 #include <MaterialXCore/Value.h>
 
+#include <cstdint>
 #include <iomanip>
+#include <limits>
 #include <sstream>
 #include <type_traits>
 
 MATERIALX_NAMESPACE_BEGIN
 
 Value::CreatorMap Value::_creatorMap;
-Value::FloatFormat Value::_floatFormat = Value::FloatFormatDefault;
-int Value::_floatPrecision = 6;
 
 namespace
 {
 
+// Float formatting is thread-local, so that threads generating shaders
+// concurrently may each apply their own scoped formatting.
+thread_local Value::FloatFormat floatFormat = Value::FloatFormatDefault;
+thread_local int floatPrecision = 6;
+
 template <class T> using enable_if_mx_vector_t =
     typename std::enable_if<std::is_base_of<VectorBase, T>::value, T>::type;
 template <class T> using enable_if_mx_matrix_t =
@@ -28,11 +33,172 @@ template <class T> class is_std_vector<vector<T>> : public std::true_type { };
 template <class T> using enable_if_std_vector_t =
     typename std::enable_if<is_std_vector<T>::value, T>::type;
 
-template <class T> void stringToData(const string& str, T& data)
+// Exact powers of ten for the fast path of floating-point parsing.
+const double POWERS_OF_TEN[] = {
+    1e0, 1e1, 1e2, 1e3, 1e4, 1e5, 1e6, 1e7, 1e8, 1e9, 1e10, 1e11,
+    1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22
+};
+
+bool isDigit(char c)
+{
+    return static_cast<unsigned>(c - '0') < 10;
+}
+
+bool isSpace(char c)
 {
-    std::stringstream ss(str);
+    return c == ' ' || (c >= '\t' && c <= '\r');
+}
+
+const char* skipSpaces(const char* ptr, const char* end)
+{
+    while (ptr != end && isSpace(*ptr))
+    {
+        ptr++;
+    }
+    return ptr;
+}
+
+// Parse a number with stream extraction in the classic locale.
+template <class T> bool parseNumberStream(const char* begin, const char* end, T& data)
+{
+    std::stringstream ss(string(begin, end));
     ss.imbue(std::locale::classic());
-    if (!(ss >> data))
+    return (bool) (ss >> data);
+}
+
+// Parse an integer from the start of the given character range, without
+// allocating or consulting the locale.  As with stream extraction, leading
+// whitespace is skipped and any characters following the number are ignored.
+template <class T> typename std::enable_if<std::is_integral<T>::value, bool>::type
+parseNumber(const char* ptr, const char* end, T& data)
+{
+    using UnsignedT = typename std::make_unsigned<T>::type;
+
+    ptr = skipSpaces(ptr, end);
+    bool negative = false;
+    if (ptr != end && (*ptr == '+' || *ptr == '-'))
+    {
+        negative = (*ptr++ == '-');
+    }
+
+    const UnsignedT limit = UnsignedT(std::numeric_limits<T>::max()) + (negative ? 1 : 0);
+    const char* digits = ptr;
+    UnsignedT value = 0;
+    for (; ptr != end && isDigit(*ptr); ptr++)
+    {
+        UnsignedT digit = UnsignedT(*ptr - '0');
+        if (value > (limit - digit) / 10)
+        {
+            return false;
+        }
+        value = value * 10 + digit;
+    }
+    if (ptr == digits)
+    {
+        return false;
+    }
+
+    data = negative ? T(-T(value - 1) - 1) : T(value);
+    return true;
+}
+
+// Parse a floating-point number from the start of the given character range,
+// without allocating or consulting the locale.  Numbers whose mantissa and
+// power of ten are both exactly representable in T are computed with a single
+// correctly rounded operation; all others fall back to stream extraction.
+template <class T> typename std::enable_if<std::is_floating_point<T>::value, bool>::type
+parseNumber(const char* begin, const char* end, T& data)
+{
+    const uint64_t MAX_MANTISSA = uint64_t(1) << std::numeric_limits<T>::digits;
+    const int MAX_EXPONENT = std::is_same<T, float>::value ? 10 : 22;
+
+    const char* ptr = skipSpaces(begin, end);
+    bool negative = false;
+    if (ptr != end && (*ptr == '+' || *ptr == '-'))
+    {
+        negative = (*ptr++ == '-');
+    }
+
+    uint64_t mantissa = 0;
+    int exponent = 0;
+    bool exact = true;
+    const char* digits = ptr;
+    for (; ptr != end && isDigit(*ptr); ptr++)
+    {
+        mantissa = mantissa * 10 + uint64_t(*ptr - '0');
+        exact = exact && mantissa <= MAX_MANTISSA;
+    }
+    size_t digitCount = ptr - digits;
+    if (ptr != end && *ptr == '.')
+    {
+        digits = ++ptr;
+        for (; ptr != end && isDigit(*ptr); ptr++, exponent--)
+        {
+            mantissa = mantissa * 10 + uint64_t(*ptr - '0');
+            exact = exact && mantissa <= MAX_MANTISSA;
+        }
+        digitCount += ptr - digits;
+    }
+    if (!digitCount)
+    {
+        return false;
+    }
+    if (ptr != end && (*ptr == 'e' || *ptr == 'E'))
+    {
+        const char* expPtr = ptr + 1;
+        bool expNegative = false;
+        if (expPtr != end && (*expPtr == '+' || *expPtr == '-'))
+        {
+            expNegative = (*expPtr++ == '-');
+        }
+        if (expPtr == end || !isDigit(*expPtr))
+        {
+            exact = false;
+        }
+        int expValue = 0;
+        for (; expPtr != end && isDigit(*expPtr) && expValue <= MAX_EXPONENT * 10; expPtr++)
+        {
+            expValue = expValue * 10 + (*expPtr - '0');
+        }
+        exponent += expNegative ? -expValue : expValue;
+    }
+
+    if (!exact || exponent > MAX_EXPONENT || exponent < -MAX_EXPONENT)
+    {
+        return parseNumberStream(begin, end, data);
+    }
+
+    T value = T(mantissa);
+    const T scale = T(POWERS_OF_TEN[exponent < 0 ? -exponent : exponent]);
+    value = (exponent < 0) ? value / scale : value * scale;
+    data = negative ? -value : value;
+    return true;
+}
+
+// Invoke the given function on each token of the string, as delimited by any
+// of the given separator characters, without allocating substrings.  Empty
+// tokens are skipped, matching splitString.
+template <class F> void forEachToken(const string& str, const string& separators, F func)
+{
+    auto isSeparator = [&separators](char c) { return separators.find(c) != string::npos; };
+    const char* ptr = str.data();
+    const char* end = ptr + str.size();
+    while (ptr != end)
+    {
+        if (isSeparator(*ptr))
+        {
+            ptr++;
+            continue;
+        }
+        const char* tokenEnd = std::find_if(ptr, end, isSeparator);
+        func(ptr, tokenEnd);
+        ptr = tokenEnd;
+    }
+}
+
+template <class T> void stringToData(const string& str, T& data)
+{
+    if (!parseNumber(str.data(), str.data() + str.size(), data))
     {
         throw ExceptionTypeError("Type mismatch in generic stringToData: " + str);
     }
@@ -55,46 +221,74 @@ template <> void stringToData(const string& str, string& data)
 
 template <class T> void stringToData(const string& str, enable_if_mx_vector_t<T>& data)
 {
-    StringVec tokens = splitString(str, ARRAY_VALID_SEPARATORS);
-    if (tokens.size() != data.numElements())
+    size_t count = 0;
+    forEachToken(str, ARRAY_VALID_SEPARATORS, [&](const char* begin, const char* end)
     {
-        throw ExceptionTypeError("Type mismatch in vector stringToData: " + str);
-    }
-    for (size_t i = 0; i < data.numElements(); i++)
+        if (count >= data.numElements() || !parseNumber(begin, end, data[count++]))
+        {
+            throw ExceptionTypeError("Type mismatch in vector stringToData: " + str);
+        }
+    });
+    if (count != data.numElements())
     {
-        stringToData(tokens[i], data[i]);
+        throw ExceptionTypeError("Type mismatch in vector stringToData: " + str);
     }
 }
 
 template <class T> void stringToData(const string& str, enable_if_mx_matrix_t<T>& data)
 {
-    StringVec tokens = splitString(str, ARRAY_VALID_SEPARATORS);
-    if (tokens.size() != data.numRows() * data.numColumns())
+    const size_t numElements = data.numRows() * data.numColumns();
+    size_t count = 0;
+    forEachToken(str, ARRAY_VALID_SEPARATORS, [&](const char* begin, const char* end)
     {
-        throw ExceptionTypeError("Type mismatch in matrix stringToData: " + str);
-    }
-    for (size_t i = 0; i < data.numRows(); i++)
-    {
-        for (size_t j = 0; j < data.numColumns(); j++)
+        if (count >= numElements ||
+            !parseNumber(begin, end, data[count / data.numColumns()][count % data.numColumns()]))
         {
-            stringToData(tokens[i * data.numRows() + j], data[i][j]);
+            throw ExceptionTypeError("Type mismatch in matrix stringToData: " + str);
         }
+        count++;
+    });
+    if (count != numElements)
+    {
+        throw ExceptionTypeError("Type mismatch in matrix stringToData: " + str);
     }
 }
 
-template <class T> void stringToData(const string& str, enable_if_std_vector_t<T>& data)
+template <class T> void stringToArray(const string& str, vector<T>& data, std::false_type)
 {
     // This code path parses an array of arbitrary substrings, so we split the string
     // in a fashion that preserves substrings with internal spaces.
     const string COMMA_SEPARATOR = ",";
     for (const string& token : splitString(str, COMMA_SEPARATOR))
     {
-        typename T::value_type val;
+        T val;
         stringToData(trimSpaces(token), val);
         data.push_back(val);
     }
 }
 
+template <class T> void stringToArray(const string& str, vector<T>& data, std::true_type)
+{
+    // Numeric arrays are parsed in place, without allocating substrings.
+    const string COMMA_SEPARATOR = ",";
+    forEachToken(str, COMMA_SEPARATOR, [&](const char* begin, const char* end)
+    {
+        T val;
+        if (!parseNumber(begin, end, val))
+        {
+            throw ExceptionTypeError("Type mismatch in array stringToData: " + str);
+        }
+        data.push_back(val);
+    });
+}
+
+template <class T> void stringToData(const string& str, enable_if_std_vector_t<T>& data)
+{
+    using ValueT = typename T::value_type;
+    using IsNumeric = std::integral_constant<bool, std::is_arithmetic<ValueT>::value && !std::is_same<ValueT, bool>::value>;
+    stringToArray(str, data, IsNumeric());
+}
+
 template <class T> void dataToString(const T& data, string& str)
 {
     std::stringstream ss;
@@ -222,6 +416,26 @@ ValuePtr Value::createValueFromStrings(const string& value, const string& type)
     return TypedValue<string>::createFromString(value);
 }
 
+void Value::setFloatFormat(FloatFormat format)
+{
+    floatFormat = format;
+}
+
+void Value::setFloatPrecision(int precision)
+{
+    floatPrecision = precision;
+}
+
+Value::FloatFormat Value::getFloatFormat()
+{
+    return floatFormat;
+}
+
+int Value::getFloatPrecision()
+{
+    return floatPrecision;
+}
+
 template <class T> bool Value::isA() const
 {
     return dynamic_cast<const TypedValue<T>*>(this) != nullptr;
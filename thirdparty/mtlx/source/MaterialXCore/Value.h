@@ -98,28 +98,18 @@ class MX_CORE_API Value
     /// Set float formatting for converting values to strings.
     /// Formats to use are FloatFormatFixed, FloatFormatScientific
     /// or FloatFormatDefault to set default format.
-    static void setFloatFormat(FloatFormat format)
-    {
-        _floatFormat = format;
-    }
+    /// Float formatting is stored per thread.
+    static void setFloatFormat(FloatFormat format);
 
     /// Set float precision for converting values to strings.
-    static void setFloatPrecision(int precision)
-    {
-        _floatPrecision = precision;
-    }
+    /// Float precision is stored per thread.
+    static void setFloatPrecision(int precision);
 
     /// Return the current float format.
-    static FloatFormat getFloatFormat()
-    {
-        return _floatFormat;
-    }
+    static FloatFormat getFloatFormat();
 
     /// Return the current float precision.
-    static int getFloatPrecision()
-    {
-        return _floatPrecision;
-    }
+    static int getFloatPrecision();
 
   protected:
     template <class T> friend class ValueRegistry;
@@ -129,8 +119,6 @@ class MX_CORE_API Value
 
   private:
     static CreatorMap _creatorMap;
-    static FloatFormat _floatFormat;
-    static int _floatPrecision;
 };
 
 /// The class template for typed subclasses of Value
@@ -116,7 +116,8 @@ class MX_CORE_API VariantAssign : public Element
     /// Set the element's variant set string.
     void setVariantSetString(const string& variantSet)
     {
-        setAttribute(VARIANT_SET_ATTRIBUTE, variantSet);
+        static const Atom VARIANT_SET_ATOM(VARIANT_SET_ATTRIBUTE);
+        setAttribute(VARIANT_SET_ATOM, variantSet);
     }
 
     /// Return true if the given element has a variant set string.
@@ -138,7 +139,8 @@ class MX_CORE_API VariantAssign : public Element
     /// Set the element's variant string.
     void setVariantString(const string& variant)
     {
-        setAttribute(VARIANT_ATTRIBUTE, variant);
+        static const Atom VARIANT_ATOM(VARIANT_ATTRIBUTE);
+        setAttribute(VARIANT_ATOM, variant);
     }
 
     /// Return true if the given element has a variant string.
@@ -0,0 +1,439 @@
+//
+// Copyright Contributors to the MaterialX Project
+// SPDX-License-Identifier: Apache-2.0
+//
+
+#include <MaterialXFormat/BinaryIo.h>
+
+#include <cstring>
+#include <fstream>
+#include <iterator>
+#include <sstream>
+#include <unordered_map>
+
+MATERIALX_NAMESPACE_BEGIN
+
+const string MTLX_BINARY_EXTENSION = "mtlxb";
+
+namespace
+{
+
+// A snapshot consists of a fixed header, a table of unique strings, a flat
+// table of element records and a flat table of attribute records.  Elements
+// are stored in depth-first order, and each record holds the index of its
+// parent, string table indices for its category, name and source URI, and
+// the range of its attributes in the attribute table.  Every record has a
+// fixed size, so any element can be located by its index.  Each attribute
+// record holds string table indices for its name and value.  All integers
+// are stored as little-endian 32-bit values.
+const char SNAPSHOT_MAGIC[8] = { 'M', 'T', 'L', 'X', 'S', 'N', 'A', 'P' };
+const uint32_t SNAPSHOT_VERSION = 2;
+const size_t ELEMENT_RECORD_SIZE = 6 * 4;
+const size_t ATTRIBUTE_RECORD_SIZE = 2 * 4;
+
+class BinaryWriter
+{
+  public:
+    BinaryWriter() :
+        _elementCount(0),
+        _attributeCount(0)
+    {
+        // Reserve index zero for the empty string.
+        addString(EMPTY_STRING);
+    }
+
+    uint32_t addString(const string& str)
+    {
+        auto it = _stringIndices.find(str);
+        if (it != _stringIndices.end())
+        {
+            return it->second;
+        }
+        uint32_t index = (uint32_t) _strings.size();
+        _stringIndices.emplace(str, index);
+        _strings.push_back(&_stringIndices.find(str)->first);
+        return index;
+    }
+
+    void addElement(ConstElementPtr elem, uint32_t parentIndex = 0)
+    {
+        uint32_t index = _elementCount++;
+        StringVec attrNames = elem->getAttributeNames();
+        writeUInt(_elements, parentIndex);
+        writeUInt(_elements, addString(elem->getCategory()));
+        writeUInt(_elements, addString(elem->getName()));
+        writeUInt(_elements, addString(elem->getSourceUri()));
+        writeUInt(_elements, _attributeCount);
+        writeUInt(_elements, (uint32_t) attrNames.size());
+        for (const string& attrName : attrNames)
+        {
+            writeUInt(_attributes, addString(attrName));
+            writeUInt(_attributes, addString(elem->getAttribute(attrName)));
+            _attributeCount++;
+        }
+
+        for (const ElementPtr& child : elem->getChildren())
+        {
+            addElement(child, index);
+        }
+    }
+
+    void write(std::ostream& stream) const
+    {
+        string header(SNAPSHOT_MAGIC, sizeof(SNAPSHOT_MAGIC));
+        writeUInt(header, SNAPSHOT_VERSION);
+        writeUInt(header, (uint32_t) _strings.size());
+        writeUInt(header, _elementCount);
+        writeUInt(header, _attributeCount);
+        stream.write(header.data(), header.size());
+
+        string table;
+        for (const string* str : _strings)
+        {
+            writeUInt(table, (uint32_t) str->size());
+            table += *str;
+        }
+        stream.write(table.data(), table.size());
+        stream.write(_elements.data(), _elements.size());
+        stream.write(_attributes.data(), _attributes.size());
+    }
+
+  private:
+    static void writeUInt(string& buffer, uint32_t value)
+    {
+        char bytes[4] = { (char) (value & 0xff),
+                          (char) ((value >> 8) & 0xff),
+                          (char) ((value >> 16) & 0xff),
+                          (char) ((value >> 24) & 0xff) };
+        buffer.append(bytes, sizeof(bytes));
+    }
+
+  private:
+    std::unordered_map<string, uint32_t> _stringIndices;
+    vector<const string*> _strings;
+    uint32_t _elementCount;
+    uint32_t _attributeCount;
+    string _elements;
+    string _attributes;
+};
+
+class BinaryReader
+{
+  public:
+    struct ElementRecord
+    {
+        uint32_t parent;
+        uint32_t category;
+        uint32_t name;
+        uint32_t sourceUri;
+        uint32_t firstAttribute;
+        uint32_t attributeCount;
+    };
+
+    BinaryReader(const char* buffer, size_t size) :
+        _pos(buffer),
+        _end(buffer + size),
+        _elementCount(0),
+        _attributeCount(0),
+        _elements(nullptr),
+        _attributes(nullptr)
+    {
+    }
+
+    void readHeader()
+    {
+        if ((size_t) (_end - _pos) < sizeof(SNAPSHOT_MAGIC) ||
+            std::memcmp(_pos, SNAPSHOT_MAGIC, sizeof(SNAPSHOT_MAGIC)) != 0)
+        {
+            throw ExceptionParseError("Binary parse error (invalid snapshot header)");
+        }
+        _pos += sizeof(SNAPSHOT_MAGIC);
+
+        uint32_t version = readUInt();
+        if (version != SNAPSHOT_VERSION)
+        {
+            throw ExceptionParseError("Binary parse error (unsupported snapshot version " + std::to_string(version) + ")");
+        }
+
+        uint32_t stringCount = readUInt();
+        _elementCount = readUInt();
+        _attributeCount = readUInt();
+        if (!stringCount || stringCount > (size_t) (_end - _pos) / 4)
+        {
+            throw ExceptionParseError("Binary parse error (invalid string table)");
+        }
+        _strings.reserve(stringCount);
+        _atoms.resize(stringCount);
+        for (uint32_t i = 0; i < stringCount; i++)
+        {
+            uint32_t length = readUInt();
+            require(length);
+            _strings.emplace_back(_pos, length);
+            _pos += length;
+        }
+
+        // The remainder of the snapshot holds exactly the element and
+        // attribute tables.
+        if (!_elementCount ||
+            _elementCount > (size_t) (_end - _pos) / ELEMENT_RECORD_SIZE ||
+            _attributeCount > (size_t) (_end - _pos) / ATTRIBUTE_RECORD_SIZE)
+        {
+            throw ExceptionParseError("Binary parse error (invalid element table)");
+        }
+        size_t tableSize = (size_t) _elementCount * ELEMENT_RECORD_SIZE + (size_t) _attributeCount * ATTRIBUTE_RECORD_SIZE;
+        if ((size_t) (_end - _pos) < tableSize)
+        {
+            throw ExceptionParseError("Binary parse error (unexpected end of snapshot)");
+        }
+        if ((size_t) (_end - _pos) > tableSize)
+        {
+            throw ExceptionParseError("Binary parse error (unexpected data after document)");
+        }
+        _elements = _pos;
+        _attributes = _pos + (size_t) _elementCount * ELEMENT_RECORD_SIZE;
+    }
+
+    uint32_t getElementCount() const
+    {
+        return _elementCount;
+    }
+
+    // Return the record of the element at the given index, with its parent,
+    // string and attribute indices checked.
+    ElementRecord getElement(uint32_t index) const
+    {
+        const char* record = _elements + (size_t) index * ELEMENT_RECORD_SIZE;
+        ElementRecord elem;
+        elem.parent = decodeUInt(record);
+        elem.category = checkString(decodeUInt(record + 4));
+        elem.name = checkString(decodeUInt(record + 8));
+        elem.sourceUri = checkString(decodeUInt(record + 12));
+        elem.firstAttribute = decodeUInt(record + 16);
+        elem.attributeCount = decodeUInt(record + 20);
+        if (index ? elem.parent >= index : elem.parent != 0)
+        {
+            throw ExceptionParseError("Binary parse error (invalid parent of element " + std::to_string(index) + ")");
+        }
+        if (elem.firstAttribute > _attributeCount || elem.attributeCount > _attributeCount - elem.firstAttribute)
+        {
+            throw ExceptionParseError("Binary parse error (invalid attributes of element " + std::to_string(index) + ")");
+        }
+        return elem;
+    }
+
+    const string& getString(uint32_t index) const
+    {
+        return _strings[index];
+    }
+
+    // Apply the attributes and source URI of the given record to an element.
+    void readAttributes(const ElementRecord& record, ElementPtr elem)
+    {
+        const string& sourceUri = _strings[record.sourceUri];
+        if (!sourceUri.empty())
+        {
+            elem->setSourceUri(sourceUri);
+        }
+        for (uint32_t i = 0; i < record.attributeCount; i++)
+        {
+            const char* attr = _attributes + (size_t) (record.firstAttribute + i) * ATTRIBUTE_RECORD_SIZE;
+            const Atom& attrName = getAtom(checkString(decodeUInt(attr)));
+            elem->setAttribute(attrName, _strings[checkString(decodeUInt(attr + 4))]);
+        }
+    }
+
+  private:
+    uint32_t readUInt()
+    {
+        require(4);
+        uint32_t value = decodeUInt(_pos);
+        _pos += 4;
+        return value;
+    }
+
+    static uint32_t decodeUInt(const char* pos)
+    {
+        const unsigned char* bytes = reinterpret_cast<const unsigned char*>(pos);
+        return (uint32_t) bytes[0] |
+               ((uint32_t) bytes[1] << 8) |
+               ((uint32_t) bytes[2] << 16) |
+               ((uint32_t) bytes[3] << 24);
+    }
+
+    uint32_t checkString(uint32_t index) const
+    {
+        if (index >= _strings.size())
+        {
+            throw ExceptionParseError("Binary parse error (string index out of range)");
+        }
+        return index;
+    }
+
+    // Return a string as an atom, interning each table entry at most once.
+    const Atom& getAtom(uint32_t index)
+    {
+        if (_atoms[index].empty() && !_strings[index].empty())
+        {
+            _atoms[index] = Atom(_strings[index]);
+        }
+        return _atoms[index];
+    }
+
+    void require(size_t count) const
+    {
+        if ((size_t) (_end - _pos) < count)
+        {
+            throw ExceptionParseError("Binary parse error (unexpected end of snapshot)");
+        }
+    }
+
+  private:
+    const char* _pos;
+    const char* _end;
+    StringVec _strings;
+    vector<Atom> _atoms;
+    uint32_t _elementCount;
+    uint32_t _attributeCount;
+    const char* _elements;
+    const char* _attributes;
+};
+
+} // anonymous namespace
+
+//
+// Reading
+//
+
+void readFromBinaryBuffer(DocumentPtr doc, const char* buffer, size_t size)
+{
+    BinaryReader reader(buffer, size);
+    reader.readHeader();
+
+    BinaryReader::ElementRecord root = reader.getElement(0);
+    if (reader.getString(root.category) != Document::CATEGORY)
+    {
+        throw ExceptionParseError("Binary parse error (snapshot root is not a document)");
+    }
+    const string& name = reader.getString(root.name);
+    if (!name.empty())
+    {
+        doc->setName(name);
+    }
+    reader.readAttributes(root, doc);
+
+    // Count the children of each element up front, so that child vectors
+    // are allocated once.
+    const uint32_t elementCount = reader.getElementCount();
+    vector<BinaryReader::ElementRecord> records(elementCount);
+    vector<uint32_t> childCounts(elementCount, 0);
+    records[0] = root;
+    for (uint32_t i = 1; i < elementCount; i++)
+    {
+        records[i] = reader.getElement(i);
+        childCounts[records[i].parent]++;
+        if (reader.getString(records[i].category).empty() || reader.getString(records[i].name).empty())
+        {
+            throw ExceptionParseError("Binary parse error (element " + std::to_string(i) + " has no category or name)");
+        }
+    }
+    if (childCounts[0])
+    {
+        doc->reserveChildren(doc->getChildren().size() + childCounts[0]);
+    }
+
+    // Create the elements in order, so that each parent precedes its
+    // children.  Elements whose name is already taken, and their
+    // descendants, are skipped.
+    vector<ElementPtr> elements(elementCount);
+    elements[0] = doc;
+    for (uint32_t i = 1; i < elementCount; i++)
+    {
+        const BinaryReader::ElementRecord& record = records[i];
+        const ElementPtr& parent = elements[record.parent];
+        const string& childName = reader.getString(record.name);
+        if (!parent || parent->getChild(childName))
+        {
+            continue;
+        }
+
+        ElementPtr elem;
+        try
+        {
+            elem = parent->addChildOfCategory(reader.getString(record.category), childName);
+        }
+        catch (const Exception& e)
+        {
+            throw ExceptionParseError("Binary parse error (" + string(e.what()) + ")");
+        }
+        if (childCounts[i])
+        {
+            elem->reserveChildren(childCounts[i]);
+        }
+        reader.readAttributes(record, elem);
+        elements[i] = elem;
+    }
+}
+
+void readFromBinaryStream(DocumentPtr doc, std::istream& stream)
+{
+    string buffer((std::istreambuf_iterator<char>(stream)), std::istreambuf_iterator<char>());
+    readFromBinaryBuffer(doc, buffer.data(), buffer.size());
+}
+
+void readFromBinaryFile(DocumentPtr doc, FilePath filename, FileSearchPath searchPath)
+{
+    searchPath.append(getEnvironmentPath());
+    filename = searchPath.find(filename);
+
+    std::ifstream file(filename.asString(), std::ios::binary | std::ios::ate);
+    if (!file)
+    {
+        throw ExceptionFileMissing("Failed to open file for reading: " + filename.asString());
+    }
+    string buffer((size_t) file.tellg(), '\0');
+    file.seekg(0);
+    if (!file.read(&buffer[0], (std::streamsize) buffer.size()))
+    {
+        throw ExceptionFileMissing("Failed to read file: " + filename.asString());
+    }
+
+    try
+    {
+        readFromBinaryBuffer(doc, buffer.data(), buffer.size());
+    }
+    catch (const ExceptionParseError& e)
+    {
+        throw ExceptionParseError(string(e.what()) + " in " + filename.asString());
+    }
+}
+
+void readFromBinaryString(DocumentPtr doc, const string& str)
+{
+    readFromBinaryBuffer(doc, str.data(), str.size());
+}
+
+//
+// Writing
+//
+
+void writeToBinaryStream(DocumentPtr doc, std::ostream& stream)
+{
+    BinaryWriter writer;
+    writer.addElement(doc);
+    writer.write(stream);
+}
+
+void writeToBinaryFile(DocumentPtr doc, const FilePath& filename)
+{
+    std::ofstream ofs(filename.asString(), std::ios::binary);
+    writeToBinaryStream(doc, ofs);
+}
+
+string writeToBinaryString(DocumentPtr doc)
+{
+    std::ostringstream stream;
+    writeToBinaryStream(doc, stream);
+    return stream.str();
+}
+
+MATERIALX_NAMESPACE_END
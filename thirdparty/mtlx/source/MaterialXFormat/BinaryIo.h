@@ -0,0 +1,91 @@
+//
+// Copyright Contributors to the MaterialX Project
+// SPDX-License-Identifier: Apache-2.0
+//
+
+#ifndef MATERIALX_BINARYIO_H
+#define MATERIALX_BINARYIO_H
+
+/// @file
+/// Support for binary document snapshots
+
+#include <MaterialXCore/Library.h>
+
+#include <MaterialXCore/Document.h>
+
+#include <MaterialXFormat/Export.h>
+#include <MaterialXFormat/File.h>
+#include <MaterialXFormat/XmlIo.h>
+
+MATERIALX_NAMESPACE_BEGIN
+
+extern MX_FORMAT_API const string MTLX_BINARY_EXTENSION;
+
+/// @name Read Functions
+/// @{
+
+/// Read a Document from a binary snapshot held in the given character buffer.
+///
+/// A binary snapshot stores a fully resolved document, with XIncludes
+/// already expanded and the document version already upgraded, so no
+/// search path or read options are required.
+///
+/// @param doc The Document into which data is read.
+/// @param buffer The character buffer from which data is read.
+/// @param size The size of the character buffer in bytes.
+/// @throws ExceptionParseError if the snapshot cannot be parsed.
+MX_FORMAT_API void readFromBinaryBuffer(DocumentPtr doc, const char* buffer, size_t size);
+
+/// Read a Document from a binary snapshot in the given input stream.
+/// @param doc The Document into which data is read.
+/// @param stream The input stream from which data is read.
+/// @throws ExceptionParseError if the snapshot cannot be parsed.
+MX_FORMAT_API void readFromBinaryStream(DocumentPtr doc, std::istream& stream);
+
+/// Read a Document from a binary snapshot with the given filename.
+/// @param doc The Document into which data is read.
+/// @param filename The filename from which data is read.  This argument can
+///    be supplied either as a FilePath or a standard string.
+/// @param searchPath An optional sequence of file paths that will be applied
+///    in order when searching for the given file.
+/// @throws ExceptionParseError if the snapshot cannot be parsed.
+/// @throws ExceptionFileMissing if the file cannot be opened.
+MX_FORMAT_API void readFromBinaryFile(DocumentPtr doc, FilePath filename, FileSearchPath searchPath = FileSearchPath());
+
+/// Read a Document from a binary snapshot held in the given string.
+/// @param doc The Document into which data is read.
+/// @param str The string from which data is read.
+/// @throws ExceptionParseError if the snapshot cannot be parsed.
+MX_FORMAT_API void readFromBinaryString(DocumentPtr doc, const string& str);
+
+/// @}
+/// @name Write Functions
+/// @{
+
+/// Write a Document as a binary snapshot to the given output stream.
+///
+/// The snapshot records every element of the document, including the source
+/// URI of elements imported from libraries, so that a document read back
+/// from the snapshot produces the same output from writeToXmlString as the
+/// original.
+///
+/// @param doc The Document to be written.
+/// @param stream The output stream to which data is written.
+MX_FORMAT_API void writeToBinaryStream(DocumentPtr doc, std::ostream& stream);
+
+/// Write a Document as a binary snapshot to the given filename.
+/// @param doc The Document to be written.
+/// @param filename The filename to which data is written.  This argument can
+///    be supplied either as a FilePath or a standard string.
+MX_FORMAT_API void writeToBinaryFile(DocumentPtr doc, const FilePath& filename);
+
+/// Write a Document as a binary snapshot to a new string, returned by value.
+/// @param doc The Document to be written.
+/// @return The output string, returned by value
+MX_FORMAT_API string writeToBinaryString(DocumentPtr doc);
+
+/// @}
+
+MATERIALX_NAMESPACE_END
+
+#endif
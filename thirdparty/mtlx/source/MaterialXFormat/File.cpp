@@ -179,6 +179,40 @@ bool FilePath::isDirectory() const
 #endif
 }
 
+int64_t FilePath::getModificationTime() const
+{
+#if defined(_WIN32)
+    WIN32_FILE_ATTRIBUTE_DATA data;
+    if (!GetFileAttributesExA(asString().c_str(), GetFileExInfoStandard, &data))
+        return 0;
+    return ((int64_t) data.ftLastWriteTime.dwHighDateTime << 32) | (int64_t) data.ftLastWriteTime.dwLowDateTime;
+#else
+    struct stat sb;
+    if (stat(asString().c_str(), &sb))
+        return 0;
+    #if defined(__APPLE__)
+    return (int64_t) sb.st_mtimespec.tv_sec * 1000000000 + (int64_t) sb.st_mtimespec.tv_nsec;
+    #else
+    return (int64_t) sb.st_mtim.tv_sec * 1000000000 + (int64_t) sb.st_mtim.tv_nsec;
+    #endif
+#endif
+}
+
+int64_t FilePath::getFileSize() const
+{
+#if defined(_WIN32)
+    WIN32_FILE_ATTRIBUTE_DATA data;
+    if (!GetFileAttributesExA(asString().c_str(), GetFileExInfoStandard, &data))
+        return 0;
+    return ((int64_t) data.nFileSizeHigh << 32) | (int64_t) data.nFileSizeLow;
+#else
+    struct stat sb;
+    if (stat(asString().c_str(), &sb))
+        return 0;
+    return (int64_t) sb.st_size;
+#endif
+}
+
 FilePathVec FilePath::getFilesInDirectory(const string& extension) const
 {
     FilePathVec files;
@@ -371,6 +405,147 @@ FilePath FilePath::getModulePath()
 #endif
 }
 
+//
+// FileSystemCache methods
+//
+
+namespace
+{
+
+// Return true if the given path string lies strictly beneath the given prefix.
+bool isPathBeneath(const string& path, const string& prefix)
+{
+    if (path.size() <= prefix.size() || path.compare(0, prefix.size(), prefix) != 0)
+    {
+        return false;
+    }
+    return (!prefix.empty() && VALID_SEPARATORS.find(prefix.back()) != string::npos) ||
+           VALID_SEPARATORS.find(path[prefix.size()]) != string::npos;
+}
+
+// Remove map entries for the given path, its descendants and its ancestors.
+template <class T> void eraseRelatedPaths(std::unordered_map<string, T>& map, const string& path)
+{
+    for (auto it = map.begin(); it != map.end();)
+    {
+        if (it->first == path || isPathBeneath(it->first, path) || isPathBeneath(path, it->first))
+        {
+            it = map.erase(it);
+        }
+        else
+        {
+            ++it;
+        }
+    }
+}
+
+} // anonymous namespace
+
+bool FileSystemCache::exists(const FilePath& path)
+{
+    return getPathStatus(path) != PathStatus::Missing;
+}
+
+bool FileSystemCache::isDirectory(const FilePath& path)
+{
+    return getPathStatus(path) == PathStatus::Directory;
+}
+
+FilePathVec FileSystemCache::getFilesInDirectory(const FilePath& dir, const string& extension)
+{
+    string key = dir.asString();
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        auto it = _directoryFiles.find(key);
+        if (it != _directoryFiles.end())
+        {
+            auto extIt = it->second.find(extension);
+            if (extIt != it->second.end())
+            {
+                return extIt->second;
+            }
+        }
+    }
+
+    // Query the file system outside the lock, so that concurrent readers
+    // are not serialized behind it.
+    FilePathVec files = dir.getFilesInDirectory(extension);
+    std::lock_guard<std::mutex> lock(_mutex);
+    _directoryFiles[key].emplace(extension, files);
+    return files;
+}
+
+FilePathVec FileSystemCache::getSubDirectories(const FilePath& dir)
+{
+    string key = dir.asString();
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        auto it = _subDirectories.find(key);
+        if (it != _subDirectories.end())
+        {
+            return it->second;
+        }
+    }
+
+    FilePathVec dirs = dir.getSubDirectories();
+    std::lock_guard<std::mutex> lock(_mutex);
+    _subDirectories.emplace(key, dirs);
+    for (const FilePath& subDir : dirs)
+    {
+        _pathStatus[subDir.asString()] = PathStatus::Directory;
+    }
+    return dirs;
+}
+
+void FileSystemCache::invalidate(const FilePath& path)
+{
+    string key = path.asString();
+    std::lock_guard<std::mutex> lock(_mutex);
+    eraseRelatedPaths(_pathStatus, key);
+    eraseRelatedPaths(_directoryFiles, key);
+    eraseRelatedPaths(_subDirectories, key);
+}
+
+void FileSystemCache::clear()
+{
+    std::lock_guard<std::mutex> lock(_mutex);
+    _pathStatus.clear();
+    _directoryFiles.clear();
+    _subDirectories.clear();
+}
+
+FileSystemCache::PathStatus FileSystemCache::getPathStatus(const FilePath& path)
+{
+    string key = path.asString();
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        auto it = _pathStatus.find(key);
+        if (it != _pathStatus.end())
+        {
+            return it->second;
+        }
+    }
+
+    PathStatus status = PathStatus::Missing;
+#if defined(_WIN32)
+    uint32_t result = GetFileAttributesA(key.c_str());
+    if (result != INVALID_FILE_ATTRIBUTES)
+    {
+        status = (result & FILE_ATTRIBUTE_DIRECTORY) ? PathStatus::Directory : PathStatus::File;
+    }
+#else
+    struct stat sb;
+    if (stat(key.c_str(), &sb) == 0)
+    {
+        status = S_ISDIR(sb.st_mode) ? PathStatus::Directory : PathStatus::File;
+    }
+#endif
+
+    std::lock_guard<std::mutex> lock(_mutex);
+    _pathStatus.emplace(key, status);
+    return status;
+}
+
 FileSearchPath getEnvironmentPath(const string& sep)
 {
     string searchPathEnv = getEnviron(MATERIALX_SEARCH_PATH_ENV_VAR);
@@ -13,11 +13,18 @@
 
 #include <MaterialXCore/Util.h>
 
+#include <mutex>
+#include <unordered_map>
+
 MATERIALX_NAMESPACE_BEGIN
 
 class FilePath;
+class FileSystemCache;
 using FilePathVec = vector<FilePath>;
 
+/// A shared pointer to a FileSystemCache
+using FileSystemCachePtr = shared_ptr<FileSystemCache>;
+
 extern MX_FORMAT_API const string PATH_LIST_SEPARATOR;
 extern MX_FORMAT_API const string MATERIALX_SEARCH_PATH_ENV_VAR;
 
@@ -187,6 +194,16 @@ class MX_FORMAT_API FilePath
     /// Return true if the given path is a directory on the file system.
     bool isDirectory() const;
 
+    /// Return the time at which the file at the given path was last modified,
+    /// in platform-specific units, or zero if the path does not exist.  The
+    /// result is suitable only for comparison with other results for the
+    /// same path.
+    int64_t getModificationTime() const;
+
+    /// Return the size in bytes of the file at the given path, or zero if
+    /// the path does not exist.
+    int64_t getFileSize() const;
+
     /// Return a vector of all files in the given directory with the given extension.
     FilePathVec getFilesInDirectory(const string& extension) const;
 
@@ -212,6 +229,59 @@ class MX_FORMAT_API FilePath
     Type _type;
 };
 
+/// @class FileSystemCache
+/// A cache of file system queries.  The existence and type of each path, and
+/// the contents of each directory, are read from the file system once and
+/// then reused until explicitly invalidated.  A cache may be shared between
+/// search paths and threads.
+class MX_FORMAT_API FileSystemCache
+{
+  public:
+    FileSystemCache() { }
+    ~FileSystemCache() { }
+
+    /// Create a new file system cache.
+    static FileSystemCachePtr create()
+    {
+        return std::make_shared<FileSystemCache>();
+    }
+
+    /// Return true if the given path exists on the file system.
+    bool exists(const FilePath& path);
+
+    /// Return true if the given path is a directory on the file system.
+    bool isDirectory(const FilePath& path);
+
+    /// Return a vector of all files in the given directory with the given extension.
+    FilePathVec getFilesInDirectory(const FilePath& dir, const string& extension);
+
+    /// Return a vector of all directories at or beneath the given path.
+    FilePathVec getSubDirectories(const FilePath& dir);
+
+    /// Discard all cached results for the given path, for paths beneath it,
+    /// and for the directories containing it.
+    void invalidate(const FilePath& path);
+
+    /// Discard all cached results.
+    void clear();
+
+  private:
+    enum class PathStatus
+    {
+        Missing,
+        File,
+        Directory
+    };
+
+    PathStatus getPathStatus(const FilePath& path);
+
+  private:
+    std::mutex _mutex;
+    std::unordered_map<string, PathStatus> _pathStatus;
+    std::unordered_map<string, std::unordered_map<string, FilePathVec>> _directoryFiles;
+    std::unordered_map<string, FilePathVec> _subDirectories;
+};
+
 /// @class FileSearchPath
 /// A sequence of file paths, which may be queried to find the first instance
 /// of a given filename on the file system.
@@ -261,13 +331,18 @@ class MX_FORMAT_API FileSearchPath
         _paths.push_back(path);
     }
 
-    /// Append the given search path to the sequence.
+    /// Append the given search path to the sequence.  If this search path
+    /// has no file system cache, then it adopts the cache of the given one.
     void append(const FileSearchPath& searchPath)
     {
         for (const FilePath& path : searchPath)
         {
             _paths.push_back(path);
         }
+        if (!_fileSystemCache)
+        {
+            _fileSystemCache = searchPath._fileSystemCache;
+        }
     }
 
     /// Prepend the given path to the sequence.
@@ -306,6 +381,41 @@ class MX_FORMAT_API FileSearchPath
         return _paths[index];
     }
 
+    /// Set the file system cache used to answer queries on this search path.
+    /// The cache is shared with copies of this search path, and defaults to
+    /// nullptr, in which case the file system is queried directly.
+    void setFileSystemCache(FileSystemCachePtr cache)
+    {
+        _fileSystemCache = cache;
+    }
+
+    /// Return the file system cache, if any, used by this search path.
+    FileSystemCachePtr getFileSystemCache() const
+    {
+        return _fileSystemCache;
+    }
+
+    /// Return true if the given path exists on the file system, consulting
+    /// the file system cache if one has been set.
+    bool exists(const FilePath& path) const
+    {
+        return _fileSystemCache ? _fileSystemCache->exists(path) : path.exists();
+    }
+
+    /// Return a vector of all files in the given directory with the given
+    /// extension, consulting the file system cache if one has been set.
+    FilePathVec getFilesInDirectory(const FilePath& dir, const string& extension) const
+    {
+        return _fileSystemCache ? _fileSystemCache->getFilesInDirectory(dir, extension) : dir.getFilesInDirectory(extension);
+    }
+
+    /// Return a vector of all directories at or beneath the given path,
+    /// consulting the file system cache if one has been set.
+    FilePathVec getSubDirectories(const FilePath& dir) const
+    {
+        return _fileSystemCache ? _fileSystemCache->getSubDirectories(dir) : dir.getSubDirectories();
+    }
+
     /// Given an input filename, iterate through each path in this sequence,
     /// returning the first combined path found on the file system.
     /// On success, the combined path is returned; otherwise the original
@@ -321,7 +431,7 @@ class MX_FORMAT_API FileSearchPath
             for (const FilePath& path : _paths)
             {
                 FilePath combined = path / filename;
-                if (combined.exists())
+                if (exists(combined))
                 {
                     return combined;
                 }
@@ -343,6 +453,7 @@ class MX_FORMAT_API FileSearchPath
 
   private:
     FilePathVec _paths;
+    FileSystemCachePtr _fileSystemCache;
 };
 
 /// Return a FileSearchPath object from search path environment variable.
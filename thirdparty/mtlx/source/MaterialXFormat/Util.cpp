@@ -5,9 +5,12 @@
 
 #include <MaterialXFormat/Util.h>
 
+#include <atomic>
+#include <exception>
 #include <fstream>
 #include <iostream>
 #include <sstream>
+#include <thread>
 
 MATERIALX_NAMESPACE_BEGIN
 
@@ -32,9 +35,9 @@ void getSubdirectories(const FilePathVec& rootDirectories, const FileSearchPath&
     for (const FilePath& root : rootDirectories)
     {
         FilePath rootPath = searchPath.find(root);
-        if (rootPath.exists())
+        if (searchPath.exists(rootPath))
         {
-            FilePathVec childDirectories = rootPath.getSubDirectories();
+            FilePathVec childDirectories = searchPath.getSubDirectories(rootPath);
             subDirectories.insert(std::end(subDirectories), std::begin(childDirectories), std::end(childDirectories));
         }
     }
@@ -44,9 +47,9 @@ void loadDocuments(const FilePath& rootPath, const FileSearchPath& searchPath, c
                    const StringSet& includeFiles, vector<DocumentPtr>& documents, StringVec& documentsPaths,
                    const XmlReadOptions* readOptions, StringVec* errors)
 {
-    for (const FilePath& dir : rootPath.getSubDirectories())
+    for (const FilePath& dir : searchPath.getSubDirectories(rootPath))
     {
-        for (const FilePath& file : dir.getFilesInDirectory(MTLX_EXTENSION))
+        for (const FilePath& file : searchPath.getFilesInDirectory(dir, MTLX_EXTENSION))
         {
             if (!skipFiles.count(file) &&
                 (includeFiles.empty() || includeFiles.count(file)))
@@ -84,33 +87,21 @@ StringSet loadLibraries(const FilePathVec& libraryFolders,
                         const FileSearchPath& searchPath,
                         DocumentPtr doc,
                         const StringSet& excludeFiles,
-                        const XmlReadOptions* readOptions)
+                        const XmlReadOptions* readOptions,
+                        unsigned int threadCount)
 {
     // Append environment path to the specified search path.
     FileSearchPath librarySearchPath = searchPath;
     librarySearchPath.append(getEnvironmentPath());
 
-    StringSet loadedLibraries;
+    // Gather the library files to load, in load order.
+    FilePathVec libraryPaths;
     if (libraryFolders.empty())
     {
         // No libraries specified so scan in all search paths
         for (const FilePath& libraryPath : librarySearchPath)
         {
-            for (const FilePath& path : libraryPath.getSubDirectories())
-            {
-                for (const FilePath& filename : path.getFilesInDirectory(MTLX_EXTENSION))
-                {
-                    if (!excludeFiles.count(filename))
-                    {
-                        const FilePath& file = path / filename;
-                        if (loadedLibraries.count(file) == 0)
-                        {
-                            loadLibrary(file, doc, searchPath, readOptions);
-                            loadedLibraries.insert(file.asString());
-                        }
-                    }
-                }
-            }
+            libraryPaths.push_back(libraryPath);
         }
     }
     else
@@ -118,24 +109,85 @@ StringSet loadLibraries(const FilePathVec& libraryFolders,
         // Look for specific library folders in the search paths
         for (const FilePath& libraryName : libraryFolders)
         {
-            FilePath libraryPath = librarySearchPath.find(libraryName);
-            for (const FilePath& path : libraryPath.getSubDirectories())
+            libraryPaths.push_back(librarySearchPath.find(libraryName));
+        }
+    }
+
+    StringSet loadedLibraries;
+    FilePathVec files;
+    for (const FilePath& libraryPath : libraryPaths)
+    {
+        for (const FilePath& path : librarySearchPath.getSubDirectories(libraryPath))
+        {
+            for (const FilePath& filename : librarySearchPath.getFilesInDirectory(path, MTLX_EXTENSION))
             {
-                for (const FilePath& filename : path.getFilesInDirectory(MTLX_EXTENSION))
+                if (!excludeFiles.count(filename))
                 {
-                    if (!excludeFiles.count(filename))
+                    const FilePath& file = path / filename;
+                    if (loadedLibraries.count(file) == 0)
                     {
-                        const FilePath& file = path / filename;
-                        if (loadedLibraries.count(file) == 0)
-                        {
-                            loadLibrary(file, doc, searchPath, readOptions);
-                            loadedLibraries.insert(file.asString());
-                        }
+                        files.push_back(file);
+                        loadedLibraries.insert(file.asString());
                     }
                 }
             }
         }
     }
+
+    if (threadCount == 0)
+    {
+        threadCount = std::max(std::thread::hardware_concurrency(), 1u);
+    }
+    threadCount = (unsigned int) std::min<size_t>(threadCount, files.size());
+
+    if (threadCount <= 1)
+    {
+        for (const FilePath& file : files)
+        {
+            loadLibrary(file, doc, searchPath, readOptions);
+        }
+        return loadedLibraries;
+    }
+
+    // Parse each file into its own document on a pool of worker threads.
+    vector<DocumentPtr> libDocs(files.size());
+    vector<std::exception_ptr> errors(files.size());
+    std::atomic<size_t> nextFile(0);
+    auto parseFiles = [&]()
+    {
+        for (size_t i = nextFile++; i < files.size(); i = nextFile++)
+        {
+            try
+            {
+                DocumentPtr libDoc = createDocument();
+                readFromXmlFile(libDoc, files[i], searchPath, readOptions);
+                libDocs[i] = libDoc;
+            }
+            catch (...)
+            {
+                errors[i] = std::current_exception();
+            }
+        }
+    };
+    vector<std::thread> threads;
+    for (unsigned int i = 0; i < threadCount; i++)
+    {
+        threads.emplace_back(parseFiles);
+    }
+    for (std::thread& thread : threads)
+    {
+        thread.join();
+    }
+
+    // Import the parsed documents in load order, matching a sequential load.
+    for (size_t i = 0; i < files.size(); i++)
+    {
+        if (errors[i])
+        {
+            std::rethrow_exception(errors[i]);
+        }
+        doc->importLibrary(libDocs[i]);
+    }
     return loadedLibraries;
 }
 
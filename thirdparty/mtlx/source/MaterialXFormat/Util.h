@@ -44,11 +44,20 @@ MX_FORMAT_API void loadLibrary(const FilePath& file,
 
 /// Load all MaterialX files within the given library folders into a document,
 /// using the given search path to locate the folders on the file system.
+/// If the search path has a FileSystemCache, then folder lookups and directory
+/// listings are answered from the cache.
+/// @param threadCount The number of threads used to parse library files.
+///    Files are parsed concurrently into separate documents, and are then
+///    imported in the same order as a sequential load, so the result does
+///    not depend on the thread count.  A value of zero selects the number
+///    of hardware threads.  Any custom XInclude function in the read options
+///    must be thread-safe when more than one thread is used.
 MX_FORMAT_API StringSet loadLibraries(const FilePathVec& libraryFolders,
                                       const FileSearchPath& searchPath,
                                       DocumentPtr doc,
                                       const StringSet& excludeFiles = StringSet(),
-                                      const XmlReadOptions* readOptions = nullptr);
+                                      const XmlReadOptions* readOptions = nullptr,
+                                      unsigned int threadCount = 1);
 
 /// Flatten all filenames in the given document, applying string resolvers at the
 /// scope of each element and removing all fileprefix attributes.
@@ -11,6 +11,7 @@
 
 #include <cstring>
 #include <fstream>
+#include <iterator>
 #include <sstream>
 
 using namespace pugi;
@@ -37,19 +38,18 @@ void elementFromXml(const xml_node& xmlNode, ElementPtr elem, const XmlReadOptio
         }
     }
 
+    // Reserve storage for all child elements up front.
+    size_t childCount = (size_t) std::distance(xmlNode.begin(), xmlNode.end());
+    if (childCount)
+    {
+        elem->reserveChildren(elem->getChildren().size() + childCount);
+    }
+
     // Create child elements and recurse.
     for (const xml_node& xmlChild : xmlNode.children())
     {
         string category = xmlChild.name();
-        string name;
-        for (const xml_attribute& xmlAttr : xmlChild.attributes())
-        {
-            if (xmlAttr.name() == Element::NAME_ATTRIBUTE)
-            {
-                name = xmlAttr.value();
-                break;
-            }
-        }
+        string name = xmlChild.attribute(Element::NAME_ATTRIBUTE.c_str()).value();
 
         // Check for duplicate elements.
         ConstElementPtr previous = elem->getChild(name);
@@ -21,6 +21,11 @@ class MX_GENOSL_API SurfaceNodeOsl : public ClosureSourceCodeNode
 
     void emitFunctionCall(const ShaderNode& node, GenContext& context, ShaderStage& stage) const override;
 
+    bool isShareable() const override
+    {
+        return false;
+    }
+
   private:
     mutable ClosureContext _cct;
 };
@@ -4,10 +4,129 @@
 //
 
 #include <MaterialXGenShader/GenContext.h>
+#include <MaterialXGenShader/Shader.h>
 #include <MaterialXGenShader/ShaderGenerator.h>
 
+#include <atomic>
+#include <thread>
+
 MATERIALX_NAMESPACE_BEGIN
 
+//
+// GenContextCore methods
+//
+
+GenContextCore::GenContextCore(ShaderGeneratorFactory factory, GenContext& prototype) :
+    _factory(factory),
+    _options(prototype.getOptions()),
+    _sourceCodeSearchPath(prototype._sourceCodeSearchPath),
+    _reservedWords(prototype.getReservedWords()),
+    _applicationVariableHandler(prototype.getApplicationVariableHandler()),
+    _colorManagementSystem(prototype.getShaderGenerator().getColorManagementSystem()),
+    _unitSystem(prototype.getShaderGenerator().getUnitSystem())
+{
+    if (!_factory)
+    {
+        throw ExceptionShaderGenError("GenContextCore must have a valid shader generator factory");
+    }
+}
+
+GenContextCorePtr GenContextCore::create(ShaderGeneratorFactory factory, GenContext& prototype)
+{
+    return GenContextCorePtr(new GenContextCore(factory, prototype));
+}
+
+ShaderGeneratorPtr GenContextCore::createShaderGenerator() const
+{
+    ShaderGeneratorPtr sg = _factory();
+    if (!sg)
+    {
+        throw ExceptionShaderGenError("Shader generator factory returned an invalid shader generator");
+    }
+    sg->setColorManagementSystem(_colorManagementSystem);
+    sg->setUnitSystem(_unitSystem);
+    return sg;
+}
+
+ShaderNodeImplPtr GenContextCore::addNodeImplementation(const string& name, ShaderNodeImplPtr impl)
+{
+    std::lock_guard<std::mutex> guard(_nodeImplMutex);
+    return _nodeImpls.emplace(name, impl).first->second;
+}
+
+ShaderNodeImplPtr GenContextCore::findNodeImplementation(const string& name) const
+{
+    std::lock_guard<std::mutex> guard(_nodeImplMutex);
+    auto it = _nodeImpls.find(name);
+    return it != _nodeImpls.end() ? it->second : nullptr;
+}
+
+void GenContextCore::getNodeImplementationNames(StringSet& names) const
+{
+    std::lock_guard<std::mutex> guard(_nodeImplMutex);
+    for (const auto& it : _nodeImpls)
+    {
+        names.insert(it.first);
+    }
+}
+
+vector<ShaderPtr> GenContextCore::generateAll(const vector<TypedElementPtr>& elements, unsigned int threadCount)
+{
+    if (threadCount == 0)
+    {
+        threadCount = std::max(std::thread::hardware_concurrency(), 1u);
+    }
+    threadCount = (unsigned int) std::min<size_t>(threadCount, elements.size());
+
+    vector<ShaderPtr> shaders(elements.size());
+    vector<std::exception_ptr> errors(elements.size());
+    std::atomic<size_t> nextElement(0);
+    GenContextCorePtr core = shared_from_this();
+    auto generateShaders = [&]()
+    {
+        // Each worker owns a context, and with it a shader generator and
+        // the per-shader state of code generation.
+        GenContext context(core);
+        for (size_t i = nextElement++; i < elements.size(); i = nextElement++)
+        {
+            try
+            {
+                shaders[i] = context.getShaderGenerator().generate(elements[i]->getName(), elements[i], context);
+            }
+            catch (...)
+            {
+                errors[i] = std::current_exception();
+            }
+        }
+    };
+
+    if (threadCount <= 1)
+    {
+        generateShaders();
+    }
+    else
+    {
+        vector<std::thread> threads;
+        for (unsigned int i = 0; i < threadCount; i++)
+        {
+            threads.emplace_back(generateShaders);
+        }
+        for (std::thread& thread : threads)
+        {
+            thread.join();
+        }
+    }
+
+    for (const std::exception_ptr& error : errors)
+    {
+        if (error)
+        {
+            std::rethrow_exception(error);
+        }
+    }
+    return shaders;
+}
+
 //
 // GenContext methods
 //
@@ -40,15 +159,34 @@ GenContext::GenContext(ShaderGeneratorPtr sg) :
     _applicationVariableHandler = nullptr;
 }
 
+GenContext::GenContext(GenContextCorePtr core) :
+    GenContext(core ? core->createShaderGenerator() : nullptr)
+{
+    _core = core;
+    _options = _core->getOptions();
+    _sourceCodeSearchPath = _core->getSourceCodeSearchPath();
+    addReservedWords(_core->getReservedWords());
+    _applicationVariableHandler = _core->getApplicationVariableHandler();
+}
+
 void GenContext::addNodeImplementation(const string& name, ShaderNodeImplPtr impl)
 {
+    if (_core && impl && impl->isShareable())
+    {
+        _core->addNodeImplementation(name, impl);
+        return;
+    }
     _nodeImpls[name] = impl;
 }
 
 ShaderNodeImplPtr GenContext::findNodeImplementation(const string& name) const
 {
     auto it = _nodeImpls.find(name);
-    return it != _nodeImpls.end() ? it->second : nullptr;
+    if (it != _nodeImpls.end())
+    {
+        return it->second;
+    }
+    return _core ? _core->findNodeImplementation(name) : nullptr;
 }
 
 void GenContext::getNodeImplementationNames(StringSet& names)
@@ -57,6 +195,10 @@ void GenContext::getNodeImplementationNames(StringSet& names)
     {
         names.insert(it.first);
     }
+    if (_core)
+    {
+        _core->getNodeImplementationNames(names);
+    }
 }
 
 void GenContext::clearNodeImplementations()
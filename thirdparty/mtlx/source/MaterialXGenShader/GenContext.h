@@ -11,12 +11,16 @@
 
 #include <MaterialXGenShader/Export.h>
 
+#include <MaterialXGenShader/ColorManagementSystem.h>
 #include <MaterialXGenShader/GenOptions.h>
 #include <MaterialXGenShader/GenUserData.h>
 #include <MaterialXGenShader/ShaderNode.h>
+#include <MaterialXGenShader/UnitSystem.h>
 
 #include <MaterialXFormat/File.h>
 
+#include <mutex>
+
 MATERIALX_NAMESPACE_BEGIN
 
 class ClosureContext;
@@ -24,6 +28,93 @@ class ClosureContext;
 /// A standard function to allow for handling of application variables for a given node
 using ApplicationVariableHandler = std::function<void(ShaderNode*, GenContext&)>;
 
+/// A function returning a new shader generator instance
+using ShaderGeneratorFactory = std::function<ShaderGeneratorPtr()>;
+
+/// @class GenContextCore
+/// The state shared by all GenContexts generating shaders for a single target.
+///
+/// A core holds the generation options, source code search path and reserved
+/// words of a prototype context, the color management and unit systems of its
+/// shader generator, and a cache of node implementations that is safe for
+/// concurrent access.  Contexts constructed from a core are cheap to create
+/// and may be used on separate threads, with each context owning its own
+/// shader generator and per-shader state.
+class MX_GENSHADER_API GenContextCore : public std::enable_shared_from_this<GenContextCore>
+{
+  public:
+    /// Create a new core from the given generator factory and prototype
+    /// context.  The factory is called once for each context constructed
+    /// from the core, and must return generators for the same target as
+    /// the generator of the prototype context.
+    static GenContextCorePtr create(ShaderGeneratorFactory factory, GenContext& prototype);
+
+    /// Create a new shader generator from the factory of this core, sharing
+    /// the color management and unit systems of the prototype generator.
+    ShaderGeneratorPtr createShaderGenerator() const;
+
+    /// Return shader generation options.
+    const GenOptions& getOptions() const
+    {
+        return _options;
+    }
+
+    /// Return the search path for finding source code during code generation.
+    const FileSearchPath& getSourceCodeSearchPath() const
+    {
+        return _sourceCodeSearchPath;
+    }
+
+    /// Return the set of reserved words that should not be used
+    /// as identifiers during code generation.
+    const StringSet& getReservedWords() const
+    {
+        return _reservedWords;
+    }
+
+    /// Get handler for application variables
+    ApplicationVariableHandler getApplicationVariableHandler() const
+    {
+        return _applicationVariableHandler;
+    }
+
+    /// Cache a shareable shader node implementation, returning the
+    /// implementation that was cached first under the given name.
+    ShaderNodeImplPtr addNodeImplementation(const string& name, ShaderNodeImplPtr impl);
+
+    /// Find and return a cached shader node implementation,
+    /// or return nullptr if no implementation is found.
+    ShaderNodeImplPtr findNodeImplementation(const string& name) const;
+
+    /// Get the names of all cached node implementations.
+    void getNodeImplementationNames(StringSet& names) const;
+
+    /// Generate shaders for the given elements on a pool of worker threads,
+    /// returning the shaders in the order of the given elements.  Each shader
+    /// is named after its element.
+    /// @param elements The elements for which shaders are generated.
+    /// @param threadCount The number of worker threads to use, where zero
+    ///    selects the hardware concurrency of the system.
+    /// @throws ExceptionShaderGenError if generation fails for an element,
+    ///    reporting the first failure in element order.
+    vector<ShaderPtr> generateAll(const vector<TypedElementPtr>& elements, unsigned int threadCount = 0);
+
+  protected:
+    GenContextCore(ShaderGeneratorFactory factory, GenContext& prototype);
+
+  protected:
+    ShaderGeneratorFactory _factory;
+    GenOptions _options;
+    FileSearchPath _sourceCodeSearchPath;
+    StringSet _reservedWords;
+    ApplicationVariableHandler _applicationVariableHandler;
+    ColorManagementSystemPtr _colorManagementSystem;
+    UnitSystemPtr _unitSystem;
+
+    std::unordered_map<string, ShaderNodeImplPtr> _nodeImpls;
+    mutable std::mutex _nodeImplMutex;
+};
+
 /// @class GenContext
 /// A context class for shader generation.
 /// Used for thread local storage of data needed during shader generation.
@@ -33,6 +124,17 @@ class MX_GENSHADER_API GenContext
     /// Constructor.
     GenContext(ShaderGeneratorPtr sg);
 
+    /// Construct a context from a shared core, with a new shader generator
+    /// created by the core.  Shareable node implementations are cached in
+    /// the core, and all other state is local to this context.
+    GenContext(GenContextCorePtr core);
+
+    /// Return the shared core of this context, if any.
+    GenContextCorePtr getCore() const
+    {
+        return _core;
+    }
+
     /// Return shader generatior.
     ShaderGenerator& getShaderGenerator()
     {
@@ -91,7 +193,8 @@ class MX_GENSHADER_API GenContext
         return _reservedWords;
     }
 
-    /// Cache a shader node implementation.
+    /// Cache a shader node implementation.  If this context has a core and
+    /// the implementation is shareable, then it is cached in the core.
     void addNodeImplementation(const string& name, ShaderNodeImplPtr impl);
 
     /// Find and return a cached shader node implementation,
@@ -101,7 +204,8 @@ class MX_GENSHADER_API GenContext
     /// Get the names of all cached node implementations.
     void getNodeImplementationNames(StringSet& names);
 
-    /// Clear all cached shader node implementation.
+    /// Clear all cached shader node implementation.  Implementations
+    /// cached in the core of this context are left unchanged.
     void clearNodeImplementations();
 
     /// Push a new closure context to use for closure evaluation.
@@ -223,7 +327,10 @@ class MX_GENSHADER_API GenContext
   protected:
     GenContext() = delete;
 
+    friend class GenContextCore;
+
     ShaderGeneratorPtr _sg;
+    GenContextCorePtr _core;
     GenOptions _options;
     FileSearchPath _sourceCodeSearchPath;
     StringSet _reservedWords;
@@ -77,6 +77,7 @@ class MX_GENSHADER_API GenOptions
   public:
     GenOptions() :
         shaderInterfaceType(SHADER_INTERFACE_COMPLETE),
+        foldInputValues(false),
         fileTextureVerticalFlip(false),
         addUpstreamDependencies(true),
         libraryPrefix("libraries"),
@@ -104,6 +105,14 @@ class MX_GENSHADER_API GenOptions
     /// Sets the type of shader interface to be generated
     ShaderInterfaceType shaderInterfaceType;
 
+    /// If true, the values of unconnected node inputs are treated as
+    /// constants when optimizing the shader graph, also with a complete
+    /// shader interface.  Nodes are then folded and merged on their input
+    /// values, and inputs optimized away are not published as uniforms.
+    /// Use this when uniforms are bound once from the document rather than
+    /// edited.  Defaults to false.
+    bool foldInputValues;
+
     /// If true the y-component of texture coordinates used for sampling
     /// file textures will be flipped before sampling. This can be used if
     /// file textures need to be flipped vertically to match the target's
@@ -24,6 +24,7 @@ class ShaderOutput;
 class ShaderNodeImpl;
 class GenOptions;
 class GenContext;
+class GenContextCore;
 class ClosureContext;
 class TypeDesc;
 
@@ -40,6 +41,8 @@ using ShaderGeneratorPtr = shared_ptr<ShaderGenerator>;
 using ShaderNodeImplPtr = shared_ptr<ShaderNodeImpl>;
 /// Shared pointer to a GenContext
 using GenContextPtr = shared_ptr<GenContext>;
+/// Shared pointer to a GenContextCore
+using GenContextCorePtr = shared_ptr<GenContextCore>;
 
 template <class T> using CreatorFunction = shared_ptr<T> (*)();
 
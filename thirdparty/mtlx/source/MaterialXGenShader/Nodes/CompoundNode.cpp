@@ -43,6 +43,7 @@ void CompoundNode::initialize(const InterfaceElement& element, GenContext& conte
     // Set hash using the function name.
     // TODO: Could be improved to include the full function signature.
     _hash = std::hash<string>{}(_functionName);
+    _contentHash = std::hash<string>{}(_functionName + "\n" + _rootGraph->getTopologySignature());
 }
 
 void CompoundNode::createVariables(const ShaderNode&, GenContext& context, Shader& shader) const
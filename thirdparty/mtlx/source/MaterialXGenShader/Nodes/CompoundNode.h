@@ -28,7 +28,13 @@ class MX_GENSHADER_API CompoundNode : public ShaderNodeImpl
 
     ShaderGraph* getGraph() const override { return _rootGraph.get(); }
 
+    size_t getContentHash() const override
+    {
+        return _contentHash;
+    }
+
   protected:
+    size_t _contentHash;
     ShaderGraphPtr _rootGraph;
     string _functionName;
 };
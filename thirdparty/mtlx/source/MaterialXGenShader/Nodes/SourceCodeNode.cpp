@@ -8,6 +8,7 @@
 #include <MaterialXGenShader/ShaderNode.h>
 #include <MaterialXGenShader/ShaderStage.h>
 #include <MaterialXGenShader/ShaderGenerator.h>
+#include <MaterialXGenShader/SourceCache.h>
 #include <MaterialXFormat/Util.h>
 
 MATERIALX_NAMESPACE_BEGIN
@@ -42,12 +43,13 @@ void SourceCodeNode::initialize(const InterfaceElement& element, GenContext& con
     {
         FilePath localPath = FilePath(impl.getActiveSourceUri()).getParentPath();
         _sourceFilename = context.resolveSourceFile(impl.getAttribute("file"), localPath);
-        _functionSource = readFile(_sourceFilename);
-        if (_functionSource.empty())
+        ConstSourceFilePtr file = SourceCache::getInstance()->getFile(_sourceFilename);
+        if (!file)
         {
             throw ExceptionShaderGenError("Failed to get source code from file '" + _sourceFilename.asString() +
                                           "' used by implementation '" + impl.getName() + "'");
         }
+        _functionSource = file->getContent();
     }
 
     // Find the function name to use
@@ -73,6 +75,7 @@ void SourceCodeNode::initialize(const InterfaceElement& element, GenContext& con
     // Set hash using the function name.
     // TODO: Could be improved to include the full function signature.
     _hash = std::hash<string>{}(_functionName);
+    _contentHash = std::hash<string>{}(_functionName + "\n" + _functionSource);
 }
 
 void SourceCodeNode::emitFunctionDefinition(const ShaderNode&, GenContext& context, ShaderStage& stage) const
@@ -25,7 +25,18 @@ class MX_GENSHADER_API SourceCodeNode : public ShaderNodeImpl
     void emitFunctionDefinition(const ShaderNode& node, GenContext& context, ShaderStage& stage) const override;
     void emitFunctionCall(const ShaderNode& node, GenContext& context, ShaderStage& stage) const override;
 
+    bool isShareable() const override
+    {
+        return true;
+    }
+
+    size_t getContentHash() const override
+    {
+        return _contentHash;
+    }
+
   protected:
+    size_t _contentHash;
     bool _inlined;
     string _functionName;
     string _functionSource;
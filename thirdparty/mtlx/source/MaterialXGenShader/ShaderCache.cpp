@@ -0,0 +1,130 @@
+//
+// Copyright Contributors to the MaterialX Project
+// SPDX-License-Identifier: Apache-2.0
+//
+
+#include <MaterialXGenShader/ShaderCache.h>
+
+#include <MaterialXGenShader/ShaderGenerator.h>
+#include <MaterialXGenShader/ShaderGraph.h>
+
+MATERIALX_NAMESPACE_BEGIN
+
+//
+// Global functions
+//
+
+string getOptionsSignature(const GenOptions& options)
+{
+    StringVec fields = {
+        std::to_string(options.shaderInterfaceType),
+        std::to_string(options.foldInputValues),
+        std::to_string(options.fileTextureVerticalFlip),
+        options.targetColorSpaceOverride,
+        options.targetDistanceUnit,
+        std::to_string(options.addUpstreamDependencies),
+        options.libraryPrefix.asString(),
+        std::to_string(options.hwTransparency),
+        std::to_string(options.hwSpecularEnvironmentMethod),
+        std::to_string(options.hwDirectionalAlbedoMethod),
+        std::to_string(options.hwTransmissionRenderMethod),
+        std::to_string(options.hwWriteDepthMoments),
+        std::to_string(options.hwShadowMap),
+        std::to_string(options.hwAmbientOcclusion),
+        std::to_string(options.hwMaxActiveLightSources),
+        std::to_string(options.hwNormalizeUdimTexCoords),
+        std::to_string(options.hwWriteAlbedoTable),
+        std::to_string(options.hwWriteEnvPrefilter),
+        std::to_string(options.hwImplicitBitangents),
+        std::to_string(options.emitColorTransforms)
+    };
+    string signature;
+    for (const string& field : fields)
+    {
+        signature += field + "|";
+    }
+    return signature;
+}
+
+//
+// ShaderCache methods
+//
+
+ShaderCache::ShaderCache() :
+    _cacheHits(0),
+    _cacheMisses(0)
+{
+}
+
+ShaderPtr ShaderCache::getShader(const string& name, ElementPtr element, GenContext& context, UniformValueMap& uniformValues)
+{
+    // Build the shader graph for the element, which is much cheaper than
+    // emitting its code, and derive the cache key from its topology.
+    ShaderGenerator& generator = context.getShaderGenerator();
+    ShaderGraphPtr graph = ShaderGraph::create(nullptr, name, element, context);
+    string key = generator.getTarget() + "\n" +
+                 getOptionsSignature(context.getOptions()) + "\n" +
+                 graph->getTopologySignature();
+
+    // Input sockets of graphs with equal topologies correspond by position,
+    // and are published under the variable names of the cached graph.
+    const vector<ShaderGraphInputSocket*>& sockets = graph->getInputSockets();
+    auto getUniformValues = [&sockets, &uniformValues](const Entry& entry)
+    {
+        uniformValues.clear();
+        for (size_t i = 0; i < sockets.size(); i++)
+        {
+            if (sockets[i]->getValue())
+            {
+                uniformValues[entry.socketVariables[i]] = sockets[i]->getValue();
+            }
+        }
+    };
+
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        auto it = _shaders.find(key);
+        if (it != _shaders.end())
+        {
+            _cacheHits++;
+            getUniformValues(it->second);
+            return it->second.shader;
+        }
+    }
+
+    // Generate the shader outside of the lock, so that other threads may be
+    // served in the meantime.
+    _cacheMisses++;
+    Entry entry;
+    entry.shader = generator.generate(name, element, context);
+    if (!entry.shader)
+    {
+        return nullptr;
+    }
+    for (const ShaderGraphInputSocket* socket : sockets)
+    {
+        entry.socketVariables.push_back(socket->getVariable());
+    }
+
+    // Another thread may have cached a shader for this key in the meantime,
+    // in which case that shader is returned, so that each topology maps to
+    // a single shader.
+    std::lock_guard<std::mutex> lock(_mutex);
+    const Entry& cached = _shaders.emplace(key, std::move(entry)).first->second;
+    getUniformValues(cached);
+    return cached.shader;
+}
+
+size_t ShaderCache::getShaderCount() const
+{
+    std::lock_guard<std::mutex> lock(_mutex);
+    return _shaders.size();
+}
+
+void ShaderCache::clear()
+{
+    std::lock_guard<std::mutex> lock(_mutex);
+    _shaders.clear();
+}
+
+MATERIALX_NAMESPACE_END
@@ -0,0 +1,108 @@
+//
+// Copyright Contributors to the MaterialX Project
+// SPDX-License-Identifier: Apache-2.0
+//
+
+#ifndef MATERIALX_SHADERCACHE_H
+#define MATERIALX_SHADERCACHE_H
+
+/// @file
+/// Cache of generated shaders keyed by shader graph topology
+
+#include <MaterialXGenShader/Export.h>
+
+#include <MaterialXGenShader/GenContext.h>
+
+#include <atomic>
+#include <mutex>
+#include <unordered_map>
+
+MATERIALX_NAMESPACE_BEGIN
+
+class ShaderCache;
+
+/// Shared pointer to a ShaderCache
+using ShaderCachePtr = shared_ptr<ShaderCache>;
+
+/// A map from the variable names of shader uniforms to their values
+using UniformValueMap = std::unordered_map<string, ValuePtr>;
+
+/// Return a string identifying the given generation options, as used in the
+/// keys of a ShaderCache.  Options that give different generated code give
+/// different signatures.
+MX_GENSHADER_API string getOptionsSignature(const GenOptions& options);
+
+/// @class ShaderCache
+/// A thread-safe cache of generated shaders, keyed by the topology of their
+/// shader graphs.
+///
+/// Materials built from the same node network with different input values
+/// generate the same code up to identifiers and uniform values.  The cache
+/// generates a shader for the first element of each topology, and returns
+/// that shader for every later element with an equal topology, together with
+/// the uniform values of the later element.
+class MX_GENSHADER_API ShaderCache
+{
+  public:
+    ShaderCache();
+    ~ShaderCache() { }
+
+    /// Create a new shader cache.
+    static ShaderCachePtr create()
+    {
+        return std::make_shared<ShaderCache>();
+    }
+
+    /// Return a shader for the given element, generating it with the shader
+    /// generator of the given context unless a shader of equal topology is
+    /// cached already.
+    ///
+    /// The key of each shader combines the target of the generator, the
+    /// generation options of the context and the topology signature of the
+    /// shader graph for the element.  Other state of the context, such as
+    /// user data, must be the same for every call on a single cache.
+    ///
+    /// @param name The name of the shader, used when generating it.
+    /// @param element The element for which a shader is returned.
+    /// @param context The context for shader generation.
+    /// @param uniformValues Set to the values of the element's inputs, keyed
+    ///    by the variable names of the corresponding uniforms of the returned
+    ///    shader.  These values should be bound in place of the uniform
+    ///    values stored in the shader.
+    /// @return The generated or cached shader.
+    ShaderPtr getShader(const string& name, ElementPtr element, GenContext& context, UniformValueMap& uniformValues);
+
+    /// Return the number of shaders in the cache.
+    size_t getShaderCount() const;
+
+    /// Remove all shaders from the cache.
+    void clear();
+
+    /// Return the number of getShader calls answered from the cache.
+    size_t getCacheHits() const
+    {
+        return _cacheHits;
+    }
+
+    /// Return the number of getShader calls that generated a new shader.
+    size_t getCacheMisses() const
+    {
+        return _cacheMisses;
+    }
+
+  private:
+    struct Entry
+    {
+        ShaderPtr shader;
+        StringVec socketVariables;
+    };
+
+    mutable std::mutex _mutex;
+    std::unordered_map<string, Entry> _shaders;
+    std::atomic<size_t> _cacheHits;
+    std::atomic<size_t> _cacheMisses;
+};
+
+MATERIALX_NAMESPACE_END
+
+#endif
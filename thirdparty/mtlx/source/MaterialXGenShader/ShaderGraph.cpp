@@ -9,6 +9,8 @@
 #include <MaterialXGenShader/ShaderGenerator.h>
 #include <MaterialXGenShader/Util.h>
 
+#include <cmath>
+#include <functional>
 #include <iostream>
 #include <queue>
 
@@ -749,6 +751,80 @@ const ShaderNode* ShaderGraph::getNode(const string& name) const
     return const_cast<ShaderGraph*>(this)->getNode(name);
 }
 
+string ShaderGraph::getTopologySignature() const
+{
+    // Identify each output by its position in the graph, so that the
+    // description is independent of node and port names.
+    std::unordered_map<const ShaderOutput*, string> outputIds;
+    for (size_t i = 0; i < _outputOrder.size(); i++)
+    {
+        outputIds[_outputOrder[i]] = "s" + std::to_string(i);
+    }
+    for (size_t i = 0; i < _nodeOrder.size(); i++)
+    {
+        const vector<ShaderOutput*>& outputs = _nodeOrder[i]->getOutputs();
+        for (size_t j = 0; j < outputs.size(); j++)
+        {
+            outputIds[outputs[j]] = "n" + std::to_string(i) + "." + std::to_string(j);
+        }
+    }
+
+    const uint32_t flagMask = ShaderPortFlag::UNIFORM | ShaderPortFlag::BIND_INPUT;
+    auto describePort = [flagMask](const ShaderPort* port, string& signature)
+    {
+        signature += port->getType()->getName();
+        signature += "|" + std::to_string(port->getFlags() & flagMask);
+        signature += "|" + port->getColorSpace();
+        signature += "|" + port->getUnit();
+        signature += "|" + port->getGeomProp();
+    };
+    auto describeInput = [&](const ShaderInput* input, string& signature)
+    {
+        describePort(input, signature);
+        const ShaderOutput* connection = input->getConnection();
+        if (connection)
+        {
+            auto it = outputIds.find(connection);
+            signature += "<" + (it != outputIds.end() ? it->second : string("?"));
+        }
+        else
+        {
+            signature += "=" + input->getValueString();
+        }
+        signature += ";";
+    };
+
+    string signature = std::to_string(getClassification()) + "\n";
+    for (const ShaderGraphInputSocket* socket : _outputOrder)
+    {
+        describePort(socket, signature);
+        signature += ";";
+    }
+    signature += "\n";
+    for (const ShaderNode* node : _nodeOrder)
+    {
+        const ShaderNodeImpl& impl = node->getImplementation();
+        signature += impl.getName() + "#" + std::to_string(impl.getContentHash());
+        signature += "#" + std::to_string(node->getClassification()) + "(";
+        for (const ShaderInput* input : node->getInputs())
+        {
+            describeInput(input, signature);
+        }
+        signature += ")";
+        for (const ShaderOutput* output : node->getOutputs())
+        {
+            describePort(output, signature);
+            signature += ";";
+        }
+        signature += "\n";
+    }
+    for (const ShaderGraphOutputSocket* socket : _inputOrder)
+    {
+        describeInput(socket, signature);
+    }
+    return signature;
+}
+
 void ShaderGraph::finalize(GenContext& context)
 {
     // Allow node implementations to update the classification
@@ -853,6 +929,311 @@ void ShaderGraph::disconnect(ShaderNode* node) const
     }
 }
 
+namespace
+{
+
+// Return the components of a scalar, vector or color value as floats,
+// or false if the value is not numeric.
+bool getValueComponents(ValuePtr value, vector<float>& components)
+{
+    components.clear();
+    if (!value)
+    {
+        return false;
+    }
+    if (value->isA<bool>())
+    {
+        components.push_back(value->asA<bool>() ? 1.0f : 0.0f);
+        return true;
+    }
+    if (value->isA<int>())
+    {
+        components.push_back(static_cast<float>(value->asA<int>()));
+        return true;
+    }
+    for (const string& str : splitString(value->getValueString(), ","))
+    {
+        try
+        {
+            components.push_back(std::stof(trimSpaces(str)));
+        }
+        catch (std::exception&)
+        {
+            return false;
+        }
+    }
+    return !components.empty();
+}
+
+// Return the components of a constant node input, or false if the input
+// is connected or carries a color space or unit that must be honored. If
+// published values are kept, inputs that will be published as editable
+// uniforms are not constant either.
+bool getConstantComponents(const ShaderInput* input, vector<float>& components, bool publishedValues)
+{
+    if (!input || input->getConnection() || !input->getColorSpace().empty() || !input->getUnit().empty())
+    {
+        return false;
+    }
+    if (publishedValues && input->getType()->isEditable() && input->getNode()->isEditable(*input))
+    {
+        return false;
+    }
+    return getValueComponents(input->getValue(), components);
+}
+
+// Return true if all components of a constant input equal the given value.
+bool isConstantValue(const ShaderInput* input, float value, bool publishedValues)
+{
+    vector<float> components;
+    if (!getConstantComponents(input, components, publishedValues))
+    {
+        return false;
+    }
+    for (float c : components)
+    {
+        if (c != value)
+        {
+            return false;
+        }
+    }
+    return true;
+}
+
+// Return true if the given type is a float based scalar, color or vector.
+bool isFoldableType(const TypeDesc* type)
+{
+    return type->getBaseType() == TypeDesc::BASETYPE_FLOAT &&
+           type->getSemantic() != TypeDesc::SEMANTIC_MATRIX &&
+           type->getSize() >= 1 && type->getSize() <= 4;
+}
+
+// Evaluate a math node with constant inputs, broadcasting scalar inputs
+// across the components of the output. Returns false if the node is not
+// foldable or the result is not finite.
+bool evaluateConstantNode(const ShaderNode& node, bool publishedValues, vector<float>& result)
+{
+    const string& category = node.getNodeString();
+    const ShaderOutput* output = node.getOutput();
+    if (category.empty() || node.numOutputs() != 1 || !isFoldableType(output->getType()))
+    {
+        return false;
+    }
+
+    using UnaryOp = std::function<float(float)>;
+    using BinaryOp = std::function<float(float, float)>;
+    static const std::unordered_map<string, UnaryOp> UNARY_OPS =
+    {
+        { "absval", [](float a) { return std::abs(a); } },
+        { "floor", [](float a) { return std::floor(a); } },
+        { "ceil", [](float a) { return std::ceil(a); } },
+        { "sign", [](float a) { return a > 0.0f ? 1.0f : (a < 0.0f ? -1.0f : 0.0f); } },
+        { "sqrt", [](float a) { return std::sqrt(a); } },
+        { "convert", [](float a) { return a; } }
+    };
+    static const std::unordered_map<string, BinaryOp> BINARY_OPS =
+    {
+        { "add", [](float a, float b) { return a + b; } },
+        { "subtract", [](float a, float b) { return a - b; } },
+        { "multiply", [](float a, float b) { return a * b; } },
+        { "divide", [](float a, float b) { return a / b; } },
+        { "modulo", [](float a, float b) { return a - b * std::floor(a / b); } },
+        { "min", [](float a, float b) { return std::min(a, b); } },
+        { "max", [](float a, float b) { return std::max(a, b); } },
+        { "power", [](float a, float b) { return a < 0.0f ? std::nanf("") : std::pow(a, b); } },
+        { "invert", [](float a, float b) { return b - a; } }
+    };
+
+    // Gather the operands in evaluation order.
+    StringVec operandNames;
+    if (UNARY_OPS.count(category))
+    {
+        operandNames = { "in" };
+    }
+    else if (category == "invert")
+    {
+        operandNames = { "in", "amount" };
+    }
+    else if (BINARY_OPS.count(category))
+    {
+        operandNames = { "in1", "in2" };
+    }
+    else if (category == "clamp")
+    {
+        operandNames = { "in", "low", "high" };
+    }
+    else if (category == "mix")
+    {
+        operandNames = { "fg", "bg", "mix" };
+    }
+    else
+    {
+        return false;
+    }
+    if (operandNames.size() != node.numInputs())
+    {
+        return false;
+    }
+
+    const size_t size = output->getType()->getSize();
+    vector<vector<float>> operands;
+    for (const string& name : operandNames)
+    {
+        const ShaderInput* input = node.getInput(name);
+        vector<float> components;
+        if (!input || !isFoldableType(input->getType()) || !getConstantComponents(input, components, publishedValues))
+        {
+            return false;
+        }
+        if (components.size() != 1 && components.size() != size)
+        {
+            return false;
+        }
+        operands.push_back(components);
+    }
+    auto operand = [&operands](size_t i, size_t c)
+    {
+        return operands[i].size() == 1 ? operands[i][0] : operands[i][c];
+    };
+
+    result.resize(size);
+    for (size_t c = 0; c < size; ++c)
+    {
+        float value = 0.0f;
+        if (category == "clamp")
+        {
+            value = std::min(std::max(operand(0, c), operand(1, c)), operand(2, c));
+        }
+        else if (category == "mix")
+        {
+            value = operand(1, c) * (1.0f - operand(2, c)) + operand(0, c) * operand(2, c);
+        }
+        else if (operands.size() == 1)
+        {
+            value = UNARY_OPS.at(category)(operand(0, c));
+        }
+        else
+        {
+            value = BINARY_OPS.at(category)(operand(0, c), operand(1, c));
+        }
+
+        if (!std::isfinite(value))
+        {
+            return false;
+        }
+        result[c] = value;
+    }
+    return true;
+}
+
+// Format the given components as the value string of a literal, using the
+// float formatting the code generator emits values with. Returns false if
+// the literal would not reproduce the components closely.
+bool formatLiteral(const vector<float>& components, string& literal)
+{
+    literal.clear();
+    for (size_t i = 0; i < components.size(); ++i)
+    {
+        const string str = Value::createValue<float>(components[i])->getValueString();
+        float emitted = 0.0f;
+        try
+        {
+            emitted = std::stof(str);
+        }
+        catch (std::exception&)
+        {
+            return false;
+        }
+        if (std::abs(emitted - components[i]) > 1e-5f * std::max(1.0f, std::abs(components[i])))
+        {
+            return false;
+        }
+        literal += (i ? ", " : "") + str;
+    }
+    return true;
+}
+
+// Return the index of the input selected by a conditional node with
+// constant selectors, or -1 if the selection is not known up front.
+int getConstantBranch(const ShaderNode& node, bool publishedValues)
+{
+    const string& category = node.getNodeString();
+    if (category == "ifgreater" || category == "ifgreatereq" || category == "ifequal")
+    {
+        const ShaderInput* in1 = node.getInput("in1");
+        const ShaderInput* in2 = node.getInput("in2");
+        vector<float> value1, value2;
+        if (!in1 || !in2 ||
+            !getConstantComponents(node.getInput("value1"), value1, publishedValues) ||
+            !getConstantComponents(node.getInput("value2"), value2, publishedValues) ||
+            value1.size() != 1 || value2.size() != 1)
+        {
+            return -1;
+        }
+        bool condition = category == "ifgreater" ? value1[0] > value2[0] :
+                         category == "ifgreatereq" ? value1[0] >= value2[0] :
+                         value1[0] == value2[0];
+        return condition ? 0 : 1;
+    }
+    if (category == "switch")
+    {
+        vector<float> which;
+        if (!getConstantComponents(node.getInput("which"), which, publishedValues) || which.size() != 1)
+        {
+            return -1;
+        }
+        // Match the branch order of the generated code, where the
+        // first branch satisfying 'which < branch + 1' is taken.
+        for (int branch = 0;; ++branch)
+        {
+            if (!node.getInput("in" + std::to_string(branch + 1)))
+            {
+                return -1;
+            }
+            if (which[0] < float(branch + 1))
+            {
+                return branch;
+            }
+        }
+    }
+    return -1;
+}
+
+// Return the input passed through unchanged by an algebraic identity
+// on the given node, or nullptr if no identity applies.
+const ShaderInput* getIdentityInput(const ShaderNode& node, bool publishedValues)
+{
+    const string& category = node.getNodeString();
+    const ShaderInput* in1 = node.getInput("in1");
+    const ShaderInput* in2 = node.getInput("in2");
+    const ShaderInput* result = nullptr;
+    if (category == "add")
+    {
+        result = isConstantValue(in2, 0.0f, publishedValues) ? in1 : (isConstantValue(in1, 0.0f, publishedValues) ? in2 : nullptr);
+    }
+    else if (category == "subtract")
+    {
+        result = isConstantValue(in2, 0.0f, publishedValues) ? in1 : nullptr;
+    }
+    else if (category == "multiply")
+    {
+        result = isConstantValue(in2, 1.0f, publishedValues) ? in1 : (isConstantValue(in1, 1.0f, publishedValues) ? in2 : nullptr);
+    }
+    else if (category == "divide" || category == "power")
+    {
+        result = isConstantValue(in2, 1.0f, publishedValues) ? in1 : nullptr;
+    }
+    else if (category == "mix")
+    {
+        const ShaderInput* mix = node.getInput("mix");
+        result = isConstantValue(mix, 0.0f, publishedValues) ? node.getInput("bg") :
+                 (isConstantValue(mix, 1.0f, publishedValues) ? node.getInput("fg") : nullptr);
+    }
+    return result && *result->getType() == *node.getOutput()->getType() ? result : nullptr;
+}
+
+} // anonymous namespace
+
 void ShaderGraph::optimize(GenContext& context)
 {
     size_t numEdits = 0;
@@ -878,6 +1259,15 @@ void ShaderGraph::optimize(GenContext& context)
         // "uniform" in the NodeDef or to handle very specific cases, like FILENAME.
     }
 
+    // Fold constant expressions. With a complete interface, only inputs
+    // that are not published as editable uniforms are constant, unless
+    // input values are folded too.
+    numEdits += foldConstants(context);
+
+    // Merge nodes computing identical results, such as repeated texture
+    // lookups or texture coordinate nodes.
+    numEdits += mergeDuplicateNodes(context);
+
     if (numEdits > 0)
     {
         std::set<ShaderNode*> usedNodesSet;
@@ -919,6 +1309,168 @@ void ShaderGraph::optimize(GenContext& context)
     }
 }
 
+size_t ShaderGraph::foldConstants(GenContext& context)
+{
+    const Syntax& syntax = context.getShaderGenerator().getSyntax();
+    const GenOptions& options = context.getOptions();
+    const bool publishedValues = options.shaderInterfaceType == SHADER_INTERFACE_COMPLETE && !options.foldInputValues;
+
+    // Visit nodes in topological order so folded values propagate downstream.
+    topologicalSort();
+
+    size_t numEdits = 0;
+    for (ShaderNode* node : getNodes())
+    {
+        ShaderOutput* output = node->numOutputs() == 1 ? node->getOutput() : nullptr;
+        if (!output || output->getConnections().empty())
+        {
+            continue;
+        }
+
+        // Fold math nodes whose inputs are all constant.
+        vector<float> result;
+        string literal;
+        if (evaluateConstantNode(*node, publishedValues, result) && formatLiteral(result, literal))
+        {
+            bool feedsGraphOutput = false;
+            for (ShaderInput* downstream : output->getConnections())
+            {
+                feedsGraphOutput |= downstream->getNode() == this;
+            }
+            if (!feedsGraphOutput)
+            {
+                ValuePtr value = Value::createValueFromStrings(literal, output->getType()->getName());
+                ShaderInputVec downstreamConnections = output->getConnections();
+                for (ShaderInput* downstream : downstreamConnections)
+                {
+                    output->breakConnection(downstream);
+                    const string& channels = downstream->getChannels();
+                    if (channels.empty())
+                    {
+                        downstream->setValue(value);
+                    }
+                    else
+                    {
+                        downstream->setValue(syntax.getSwizzledValue(value, output->getType(), channels, downstream->getType()));
+                        downstream->setChannels(EMPTY_STRING);
+                    }
+                }
+                ++numEdits;
+                continue;
+            }
+        }
+
+        // Remove unused branches of conditionals with constant selectors,
+        // and pass inputs through algebraic identities.
+        const ShaderInput* passthrough = nullptr;
+        int branch = getConstantBranch(*node, publishedValues);
+        if (branch >= 0)
+        {
+            passthrough = node->getInput(node->getNodeString() == "switch" ? "in" + std::to_string(branch + 1) :
+                                                                             (branch == 0 ? "in1" : "in2"));
+        }
+        else
+        {
+            passthrough = getIdentityInput(*node, publishedValues);
+        }
+        if (passthrough)
+        {
+            for (size_t i = 0; i < node->numInputs(); ++i)
+            {
+                if (node->getInput(i) == passthrough)
+                {
+                    bypass(context, node, i);
+                    ++numEdits;
+                    break;
+                }
+            }
+        }
+    }
+    return numEdits;
+}
+
+size_t ShaderGraph::mergeDuplicateNodes(GenContext& context)
+{
+    // With a complete interface each unconnected input is published as its
+    // own editable uniform, so nodes with such inputs must stay distinct,
+    // unless input values are folded and nodes can be merged on them.
+    const GenOptions& options = context.getOptions();
+    const bool publishedValues = options.shaderInterfaceType == SHADER_INTERFACE_COMPLETE && !options.foldInputValues;
+    const uint32_t excludedClassification = ShaderNode::Classification::CLOSURE |
+                                            ShaderNode::Classification::SHADER |
+                                            ShaderNode::Classification::MATERIAL;
+
+    // Visit nodes in topological order so upstream duplicates are merged
+    // before the nodes connected to them are compared.
+    topologicalSort();
+
+    std::unordered_map<string, ShaderNode*> uniqueNodes;
+    size_t numEdits = 0;
+    for (ShaderNode* node : getNodes())
+    {
+        if (node->getClassification() & excludedClassification)
+        {
+            continue;
+        }
+
+        // Describe the node by its implementation, upstream connections
+        // and input values.
+        const ShaderNodeImpl& impl = node->getImplementation();
+        string key = impl.getName() + "#" + std::to_string(impl.getHash()) + "#" + node->getNodeString() + "(";
+        bool mergeable = true;
+        for (const ShaderInput* input : node->getInputs())
+        {
+            key += input->getName() + ":" + input->getType()->getName();
+            key += "|" + input->getChannels();
+            key += "|" + input->getColorSpace();
+            key += "|" + input->getUnit();
+            key += "|" + input->getGeomProp();
+            const ShaderOutput* connection = input->getConnection();
+            if (connection)
+            {
+                key += "<" + connection->getNode()->getName() + "." + connection->getName();
+            }
+            else if (publishedValues && input->getType()->isEditable() && node->isEditable(*input))
+            {
+                mergeable = false;
+                break;
+            }
+            else
+            {
+                key += "=" + input->getValueString();
+            }
+            key += ";";
+        }
+        if (!mergeable)
+        {
+            continue;
+        }
+
+        auto it = uniqueNodes.emplace(key + ")", node);
+        if (it.second)
+        {
+            continue;
+        }
+
+        // Route the downstream connections of the duplicate to the
+        // matching outputs of the first node with the same description.
+        ShaderNode* original = it.first->second;
+        for (size_t i = 0; i < node->numOutputs(); ++i)
+        {
+            ShaderOutput* output = node->getOutput(i);
+            ShaderOutput* replacement = original->getOutput(i);
+            ShaderInputVec downstreamConnections = output->getConnections();
+            for (ShaderInput* downstream : downstreamConnections)
+            {
+                output->breakConnection(downstream);
+                downstream->makeConnection(replacement);
+            }
+        }
+        ++numEdits;
+    }
+    return numEdits;
+}
+
 void ShaderGraph::bypass(GenContext& context, ShaderNode* node, size_t inputIndex, size_t outputIndex)
 {
     ShaderInput* input = node->getInput(inputIndex);
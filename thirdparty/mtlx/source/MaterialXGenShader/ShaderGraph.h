@@ -111,6 +111,22 @@ class MX_GENSHADER_API ShaderGraph : public ShaderNode
     /// Return the map of unique identifiers used in the scope of this graph.
     IdentifierMap& getIdentifierMap() { return _identifiers; }
 
+    /// Return a canonical description of the topology of this graph.
+    ///
+    /// The description covers the implementations and classifications of
+    /// nodes, their connections, the types and flags of ports, and the values
+    /// of unconnected node inputs, which are emitted as constants.  Names and
+    /// the values of input sockets, which are emitted as uniforms, are left
+    /// out, so graphs with equal topologies generate the same code up to
+    /// identifiers and uniform values.
+    string getTopologySignature() const;
+
+    /// Return a hash of the topology signature of this graph.
+    size_t getTopologyHash() const
+    {
+        return std::hash<string>{}(getTopologySignature());
+    }
+
   protected:
     /// Create node connections corresponding to the connection between a pair of elements.
     /// @param downstreamElement Element representing the node to connect to.
@@ -154,6 +170,20 @@ class MX_GENSHADER_API ShaderGraph : public ShaderNode
     /// Optimize the graph, removing redundant paths.
     void optimize(GenContext& context);
 
+    /// Fold math nodes whose inputs are all constant, remove unused branches
+    /// of conditionals with constant selectors and bypass nodes reduced to
+    /// algebraic identities. With a complete interface, inputs published
+    /// as uniforms only count as constant if GenOptions::foldInputValues
+    /// is set. Returns the number of edits made.
+    size_t foldConstants(GenContext& context);
+
+    /// Merge nodes sharing an implementation, upstream connections and
+    /// input values, keeping the first of each set of duplicates. With a
+    /// complete interface, nodes with inputs published as uniforms are only
+    /// merged if GenOptions::foldInputValues is set. Returns the number of
+    /// nodes merged.
+    size_t mergeDuplicateNodes(GenContext& context);
+
     /// Bypass a node for a particular input and output,
     /// effectively connecting the input's upstream connection
     /// with the output's downstream connections.
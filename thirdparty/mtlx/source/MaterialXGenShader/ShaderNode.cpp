@@ -165,6 +165,7 @@ ShaderNode::ShaderNode(const ShaderGraph* parent, const string& name) :
 ShaderNodePtr ShaderNode::create(const ShaderGraph* parent, const string& name, const NodeDef& nodeDef, GenContext& context)
 {
     ShaderNodePtr newNode = std::make_shared<ShaderNode>(parent, name);
+    newNode->_nodeString = nodeDef.getNodeString();
 
     const ShaderGenerator& shadergen = context.getShaderGenerator();
 
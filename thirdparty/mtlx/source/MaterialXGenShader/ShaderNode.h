@@ -432,6 +432,13 @@ class MX_GENSHADER_API ShaderNode
         return _name;
     }
 
+    /// Return the node string of the NodeDef this node was created from,
+    /// or an empty string if the node was created from an implementation.
+    const string& getNodeString() const
+    {
+        return _nodeString;
+    }
+
     /// Return the implementation used for this node.
     const ShaderNodeImpl& getImplementation() const
     {
@@ -497,6 +504,7 @@ class MX_GENSHADER_API ShaderNode
 
     const ShaderGraph* _parent;
     string _name;
+    string _nodeString;
     uint32_t _classification;
 
     std::unordered_map<string, ShaderInputPtr> _inputMap;
@@ -58,6 +58,15 @@ class MX_GENSHADER_API ShaderNodeImpl
         return _hash;
     }
 
+    /// Return a hash of the content of this implementation, such as its
+    /// source code or node graph, which tells apart implementations of the
+    /// same name that emit different code, e.g. when defined by different
+    /// libraries.  Defaults to the hash returned by getHash.
+    virtual size_t getContentHash() const
+    {
+        return _hash;
+    }
+
     /// Add additional inputs on a node.
     virtual void addInputs(ShaderNode& node, GenContext& context) const;
 
@@ -80,6 +89,14 @@ class MX_GENSHADER_API ShaderNodeImpl
     /// Emit declaration and initialization of output variables to use in a function call.
     virtual void emitOutputVariables(const ShaderNode& node, GenContext& context, ShaderStage& stage) const;
 
+    /// Return true if this implementation holds no state that changes after
+    /// initialization, so that a single instance may be used by GenContexts
+    /// on several threads at once.  By default implementations are not shareable.
+    virtual bool isShareable() const
+    {
+        return false;
+    }
+
     /// Return a pointer to the graph if this implementation is using a graph,
     /// or returns nullptr otherwise.
     virtual ShaderGraph* getGraph() const;
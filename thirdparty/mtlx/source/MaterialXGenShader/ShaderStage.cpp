@@ -7,6 +7,7 @@
 
 #include <MaterialXGenShader/ShaderGenerator.h>
 #include <MaterialXGenShader/GenContext.h>
+#include <MaterialXGenShader/SourceCache.h>
 #include <MaterialXGenShader/Syntax.h>
 #include <MaterialXGenShader/Util.h>
 
@@ -312,12 +313,22 @@ void ShaderStage::addComment(const string& str)
 
 void ShaderStage::addBlock(const string& str, const FilePath& sourceFilename, GenContext& context)
 {
-    const string& INCLUDE = _syntax->getIncludeStatement();
-    const string& QUOTE   = _syntax->getStringQuote();
-
     // Add each line in the block seperately to get correct indentation.
+    StringVec lines;
     StringStream stream(str);
     for (string line; std::getline(stream, line);)
+    {
+        lines.push_back(std::move(line));
+    }
+    addBlockLines(lines, sourceFilename, context);
+}
+
+void ShaderStage::addBlockLines(const StringVec& lines, const FilePath& sourceFilename, GenContext& context)
+{
+    const string& INCLUDE = _syntax->getIncludeStatement();
+    const string& QUOTE   = _syntax->getStringQuote();
+
+    for (const string& line : lines)
     {
         size_t pos = line.find(INCLUDE);
         if (pos != string::npos)
@@ -349,13 +360,13 @@ void ShaderStage::addInclude(const FilePath& includeFilename, const FilePath& so
 
     if (!_includes.count(resolvedFile))
     {
-        string content = readFile(resolvedFile);
-        if (content.empty())
+        ConstSourceFilePtr file = SourceCache::getInstance()->getFile(resolvedFile);
+        if (!file)
         {
             throw ExceptionShaderGenError("Could not find include file: '" + includeFilename.asString() + "'");
         }
         _includes.insert(resolvedFile);
-        addBlock(content, resolvedFile, context);
+        addBlockLines(file->getLines(), resolvedFile, context);
     }
 }
 
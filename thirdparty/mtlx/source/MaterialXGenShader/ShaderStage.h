@@ -286,6 +286,10 @@ class MX_GENSHADER_API ShaderStage
         _functionName = functionName;
     }
 
+  private:
+    /// Add a block of code that has been split into lines.
+    void addBlockLines(const StringVec& lines, const FilePath& sourceFilename, GenContext& context);
+
   private:
     /// Name of the stage
     const string _name;
@@ -0,0 +1,80 @@
+//
+// Copyright Contributors to the MaterialX Project
+// SPDX-License-Identifier: Apache-2.0
+//
+
+#include <MaterialXGenShader/SourceCache.h>
+
+#include <MaterialXFormat/Util.h>
+
+#include <sstream>
+
+MATERIALX_NAMESPACE_BEGIN
+
+//
+// SourceFile methods
+//
+
+SourceFile::SourceFile(string content) :
+    _content(std::move(content))
+{
+    std::istringstream stream(_content);
+    for (string line; std::getline(stream, line);)
+    {
+        _lines.push_back(std::move(line));
+    }
+}
+
+//
+// SourceCache methods
+//
+
+SourceCache::SourceCache() :
+    _cacheHits(0),
+    _cacheMisses(0)
+{
+}
+
+const SourceCachePtr& SourceCache::getInstance()
+{
+    static const SourceCachePtr instance = create();
+    return instance;
+}
+
+ConstSourceFilePtr SourceCache::getFile(const FilePath& filename)
+{
+    const string key = filename.asString();
+    int64_t modificationTime = filename.getModificationTime();
+    int64_t fileSize = filename.getFileSize();
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        auto it = _files.find(key);
+        if (it != _files.end() && it->second.modificationTime == modificationTime && it->second.fileSize == fileSize)
+        {
+            _cacheHits++;
+            return it->second.file;
+        }
+    }
+
+    // Read and split the file outside of the lock, so that other threads
+    // may be served in the meantime.
+    _cacheMisses++;
+    string content = readFile(filename);
+    if (content.empty())
+    {
+        return nullptr;
+    }
+    ConstSourceFilePtr file = std::make_shared<SourceFile>(std::move(content));
+
+    std::lock_guard<std::mutex> lock(_mutex);
+    _files[key] = Entry{ modificationTime, fileSize, file };
+    return file;
+}
+
+void SourceCache::clear()
+{
+    std::lock_guard<std::mutex> lock(_mutex);
+    _files.clear();
+}
+
+MATERIALX_NAMESPACE_END
@@ -0,0 +1,117 @@
+//
+// Copyright Contributors to the MaterialX Project
+// SPDX-License-Identifier: Apache-2.0
+//
+
+#ifndef MATERIALX_SOURCECACHE_H
+#define MATERIALX_SOURCECACHE_H
+
+/// @file
+/// Process-wide cache of shader source files
+
+#include <MaterialXGenShader/Export.h>
+
+#include <MaterialXFormat/File.h>
+
+#include <atomic>
+#include <mutex>
+#include <unordered_map>
+
+MATERIALX_NAMESPACE_BEGIN
+
+class SourceFile;
+class SourceCache;
+
+/// Shared pointer to a constant SourceFile
+using ConstSourceFilePtr = shared_ptr<const SourceFile>;
+
+/// Shared pointer to a SourceCache
+using SourceCachePtr = shared_ptr<SourceCache>;
+
+/// @class SourceFile
+/// The content of a shader source file, as held by a SourceCache.
+class MX_GENSHADER_API SourceFile
+{
+  public:
+    SourceFile(string content);
+
+    /// Return the full text of the file.
+    const string& getContent() const
+    {
+        return _content;
+    }
+
+    /// Return the text of the file split into lines.
+    const StringVec& getLines() const
+    {
+        return _lines;
+    }
+
+  private:
+    string _content;
+    StringVec _lines;
+};
+
+/// @class SourceCache
+/// A thread-safe cache of the source files read during shader generation.
+///
+/// Include files and implementation source files are shared by many
+/// shaders, so the cache holds each file in memory after its first use,
+/// keyed by its resolved path.  A cached file is read again if its
+/// modification time or size on disk changes, so that rewrites within the
+/// timestamp resolution of the file system are detected whenever they change
+/// the length of the file.
+class MX_GENSHADER_API SourceCache
+{
+  public:
+    SourceCache();
+    ~SourceCache() { }
+
+    /// Create a new source cache.
+    static SourceCachePtr create()
+    {
+        return std::make_shared<SourceCache>();
+    }
+
+    /// Return the cache shared by all shader generators in the process.
+    static const SourceCachePtr& getInstance();
+
+    /// Return the content of the given source file, reading it from disk if
+    /// it is not cached or has been modified since it was cached.
+    /// @param filename The resolved path of the source file.
+    /// @return The content of the file, or an empty shared pointer if the
+    ///    file is missing or empty.
+    ConstSourceFilePtr getFile(const FilePath& filename);
+
+    /// Remove all files from the cache.
+    void clear();
+
+    /// Return the number of getFile calls answered from the cache.
+    size_t getCacheHits() const
+    {
+        return _cacheHits;
+    }
+
+    /// Return the number of getFile calls that read the file from disk.
+    size_t getCacheMisses() const
+    {
+        return _cacheMisses;
+    }
+
+  private:
+    struct Entry
+    {
+        int64_t modificationTime;
+        int64_t fileSize;
+        ConstSourceFilePtr file;
+    };
+
+    std::mutex _mutex;
+    std::unordered_map<string, Entry> _files;
+    std::atomic<size_t> _cacheHits;
+    std::atomic<size_t> _cacheMisses;
+};
+
+MATERIALX_NAMESPACE_END
+
+#endif
@@ -219,7 +219,7 @@ ImagePtr ImageHandler::loadImage(const FilePath& filePath)
 
     if (!filePath.isEmpty())
     {
-        if (!filePath.exists())
+        if (!_searchPath.exists(filePath))
         {
             std::cerr << string("Image file not found: ") + filePath.asString() << std::endl;
         }
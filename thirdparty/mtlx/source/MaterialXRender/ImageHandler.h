@@ -206,6 +206,8 @@ class MX_RENDER_API ImageHandler
     void unbindImages();
 
     /// Set the search path to be used for finding images on the file system.
+    /// If the search path has a FileSystemCache, then image lookups in
+    /// acquireImage are answered from the cache.
     void setSearchPath(const FileSearchPath& path)
     {
         _searchPath = path;
@@ -8,6 +8,8 @@
 #include <MaterialXCore/Util.h>
 #include <MaterialXCore/Document.h>
 
+#include <thread>
+
 namespace mx = MaterialX;
 
 TEST_CASE("String utilities", "[coreutil]")
@@ -30,6 +32,54 @@ TEST_CASE("String utilities", "[coreutil]")
     REQUIRE(mx::splitString("[one...two...three]", "[.]") == (std::vector<std::string>{"one", "two", "three"}));
 }
 
+TEST_CASE("Atoms", "[coreutil]")
+{
+    std::string name("nodedef");
+    mx::Atom atom1(name);
+    mx::Atom atom2(std::string("node") + "def");
+    REQUIRE(atom1 == atom2);
+    REQUIRE(&atom1.str() == &atom2.str());
+    REQUIRE(atom1 == name);
+    REQUIRE(atom1 != mx::Atom("nodegraph"));
+
+    REQUIRE(mx::Atom().empty());
+    REQUIRE(mx::Atom(mx::EMPTY_STRING) == mx::Atom());
+    REQUIRE(mx::Atom().str().empty());
+
+    // Attribute lookups by atom and by string agree.
+    mx::DocumentPtr doc = mx::createDocument();
+    mx::NodeDefPtr nodeDef = doc->addNodeDef("ND_test", "float", "test");
+    REQUIRE(nodeDef->getAttribute(mx::Atom("node")) == "test");
+    REQUIRE(nodeDef->hasAttribute(mx::Atom("node")));
+    REQUIRE(!nodeDef->hasAttribute(mx::Atom("nodegroup")));
+    nodeDef->removeAttribute("node");
+    REQUIRE(nodeDef->getAttribute(mx::Atom("node")).empty());
+
+    // Threads interning the same new strings concurrently share storage.
+    const size_t threadCount = 4;
+    const size_t atomCount = 1000;
+    std::vector<std::vector<const std::string*>> interned(threadCount);
+    std::vector<std::thread> threads;
+    for (size_t i = 0; i < threadCount; i++)
+    {
+        threads.emplace_back([&interned, i]()
+        {
+            for (size_t j = 0; j < atomCount; j++)
+            {
+                interned[i].push_back(&mx::Atom("concurrentAtom" + std::to_string(j)).str());
+            }
+        });
+    }
+    for (std::thread& thread : threads)
+    {
+        thread.join();
+    }
+    for (size_t i = 1; i < threadCount; i++)
+    {
+        REQUIRE(interned[i] == interned[0]);
+    }
+}
+
 TEST_CASE("Print utilities", "[coreutil]")
 {
     // Create a document.
@@ -109,3 +109,306 @@ TEST_CASE("Document", "[document]")
     // Validate the combined document.
     REQUIRE(doc->validate());
 }
+
+TEST_CASE("Data library", "[document]")
+{
+    mx::FileSearchPath searchPath = mx::getDefaultDataSearchPath();
+
+    // Load the standard libraries into a shared data library.
+    mx::DocumentPtr stdLib = mx::createDocument();
+    mx::loadLibraries({ "libraries" }, searchPath, stdLib);
+    REQUIRE(!stdLib->getNodeDefs().empty());
+
+    // Reference the data library from a content document, rather than importing it.
+    mx::DocumentPtr doc = mx::createDocument();
+    doc->setDataLibrary(stdLib);
+    REQUIRE(doc->hasDataLibrary());
+    REQUIRE(doc->getChildren().empty());
+    mx::readFromXmlFile(doc, "resources/Materials/Examples/StandardSurface/standard_surface_marble_solid.mtlx", searchPath);
+
+    // Definitions resolve through the data library without being copied.
+    REQUIRE(doc->getNodeDefs().empty());
+    REQUIRE(doc->getNodeDef("ND_standard_surface_surfaceshader") == stdLib->getNodeDef("ND_standard_surface_surfaceshader"));
+    REQUIRE(!doc->getMatchingNodeDefs("standard_surface").empty());
+    REQUIRE(!doc->getMatchingImplementations("ND_standard_surface_surfaceshader").empty());
+    for (mx::NodePtr node : doc->getNodes())
+    {
+        mx::NodeDefPtr nodeDef = node->getNodeDef();
+        REQUIRE(nodeDef);
+        REQUIRE(nodeDef->getDocument() == stdLib);
+    }
+    std::string message;
+    bool docValid = doc->validate(&message);
+    INFO(message);
+    REQUIRE(docValid);
+
+    // Local definitions take precedence over the data library.
+    mx::NodeDefPtr localNodeDef = doc->addNodeDef("ND_standard_surface_surfaceshader", mx::SURFACE_SHADER_TYPE_STRING, "standard_surface");
+    REQUIRE(doc->getNodeDef("ND_standard_surface_surfaceshader") == localNodeDef);
+    REQUIRE(doc->getMatchingNodeDefs("standard_surface").front() == localNodeDef);
+
+    // Lists of definitions append those of the data library, unless overridden.
+    mx::AttributeDefPtr libraryAttrDef = stdLib->addAttributeDef("AD_test");
+    stdLib->addAttributeDef("AD_shadowed");
+    mx::AttributeDefPtr localAttrDef = doc->addAttributeDef("AD_shadowed");
+    std::vector<mx::AttributeDefPtr> attrDefs = doc->getAttributeDefs();
+    REQUIRE(attrDefs.size() == 2);
+    REQUIRE(attrDefs[0] == localAttrDef);
+    REQUIRE(attrDefs[1] == libraryAttrDef);
+    REQUIRE(doc->getImplementations().size() == stdLib->getImplementations().size());
+
+    // Nodegraphs find their nodedef through implementations in the data library.
+    mx::NodeDefPtr graphNodeDef = stdLib->addNodeDef("ND_test_graph", "float", "test_graph");
+    mx::ImplementationPtr graphImpl = stdLib->addImplementation("IM_test_graph");
+    graphImpl->setNodeDef(graphNodeDef);
+    graphImpl->setNodeGraph("NG_test_graph");
+    mx::NodeGraphPtr graph = doc->addNodeGraph("NG_test_graph");
+    REQUIRE(graph->getNodeDef() == graphNodeDef);
+
+    // Copies share the data library reference.
+    mx::DocumentPtr docCopy = doc->copy();
+    REQUIRE(docCopy->getDataLibrary() == stdLib);
+}
+
+TEST_CASE("Shared data library", "[document]")
+{
+    mx::FileSearchPath searchPath = mx::getDefaultDataSearchPath();
+    mx::DocumentPtr libraries = mx::createDocument();
+    mx::loadLibraries({ "libraries" }, searchPath, libraries);
+    libraries->setReadOnly(true);
+    REQUIRE(libraries->isReadOnly());
+
+    // Documents referencing a shared library hold only their own content.
+    std::vector<mx::DocumentPtr> docs;
+    for (int i = 0; i < 3; i++)
+    {
+        mx::DocumentPtr doc = mx::createDocument();
+        doc->setDataLibrary(libraries);
+        doc->addNode("image", "image1", "color3");
+        REQUIRE(doc->getChildren().size() == 1);
+        REQUIRE(doc->getNodeDef("ND_image_color3") == libraries->getNodeDef("ND_image_color3"));
+        docs.push_back(doc);
+    }
+
+    // Shared elements cannot be edited in place.
+    mx::NodeDefPtr sharedNodeDef = docs[0]->getNodeDef("ND_image_color3");
+    size_t libraryEpoch = libraries->getModificationEpoch();
+    REQUIRE_THROWS_AS(sharedNodeDef->setAttribute("doc", "edited"), mx::ExceptionReadOnlyDocument);
+    REQUIRE_THROWS_AS(sharedNodeDef->getInput("file")->setValueString("edited.png"), mx::ExceptionReadOnlyDocument);
+    REQUIRE_THROWS_AS(sharedNodeDef->addInput("extra", "float"), mx::ExceptionReadOnlyDocument);
+    REQUIRE_THROWS_AS(libraries->removeNodeDef("ND_image_color3"), mx::ExceptionReadOnlyDocument);
+    REQUIRE(!sharedNodeDef->hasAttribute("doc"));
+    REQUIRE(!sharedNodeDef->getInput("extra"));
+    REQUIRE(libraries->getModificationEpoch() == libraryEpoch);
+
+    // An editable copy is imported into the requesting document alone.
+    mx::ElementPtr localElem = docs[0]->materializeDataLibraryElement("ND_image_color3");
+    REQUIRE(localElem);
+    REQUIRE(localElem->getDocument() == docs[0]);
+    REQUIRE(docs[0]->materializeDataLibraryElement("ND_image_color3") == localElem);
+    REQUIRE(!docs[0]->materializeDataLibraryElement("ND_missing"));
+    localElem->setAttribute("doc", "edited");
+    REQUIRE(docs[0]->getNodeDef("ND_image_color3") == localElem);
+    REQUIRE(docs[0]->getNodes().front()->getNodeDef() == localElem);
+    REQUIRE(docs[1]->getNodeDef("ND_image_color3") == sharedNodeDef);
+    REQUIRE(!sharedNodeDef->hasAttribute("doc"));
+
+    // Read-only state may be lifted again.
+    libraries->setReadOnly(false);
+    sharedNodeDef->setAttribute("doc", "edited");
+    REQUIRE(libraries->getModificationEpoch() > libraryEpoch);
+}
+
+TEST_CASE("Document cache", "[document]")
+{
+    mx::DocumentPtr doc = mx::createDocument();
+
+    // Populate the cache with an initial lookup.
+    mx::NodeDefPtr nodeDef = doc->addNodeDef("ND_custom_float", "float", "custom");
+    REQUIRE(doc->getMatchingNodeDefs("custom").size() == 1);
+
+    // Added, edited and removed definitions are reflected in later lookups.
+    mx::NodeDefPtr nodeDef2 = doc->addNodeDef("ND_custom_color3", "color3", "custom");
+    REQUIRE(doc->getMatchingNodeDefs("custom").size() == 2);
+    nodeDef2->setNodeString("custom2");
+    REQUIRE(doc->getMatchingNodeDefs("custom").size() == 1);
+    REQUIRE(doc->getMatchingNodeDefs("custom2").front() == nodeDef2);
+    doc->removeNodeDef(nodeDef2->getName());
+    REQUIRE(doc->getMatchingNodeDefs("custom2").empty());
+
+    // Namespaces apply to the elements below them.
+    doc->setNamespace("ns");
+    REQUIRE(doc->getMatchingNodeDefs("custom").empty());
+    REQUIRE(doc->getMatchingNodeDefs("ns:custom").front() == nodeDef);
+    doc->removeAttribute(mx::Element::NAMESPACE_ATTRIBUTE);
+    REQUIRE(doc->getMatchingNodeDefs("custom").front() == nodeDef);
+
+    // Implementations referencing a nodegraph resolve it at lookup time.
+    mx::ImplementationPtr impl = doc->addImplementation("IM_custom_float");
+    impl->setNodeDef(nodeDef);
+    impl->setNodeGraph("NG_custom_float");
+    REQUIRE(doc->getMatchingImplementations(nodeDef->getName()).empty());
+    mx::NodeGraphPtr nodeGraph = doc->addNodeGraph("NG_custom_float");
+    REQUIRE(doc->getMatchingImplementations(nodeDef->getName()).front() == nodeGraph);
+
+    // Port elements follow their node name.
+    mx::NodeGraphPtr graph = doc->addNodeGraph();
+    mx::NodePtr constant = graph->addNode("constant");
+    mx::OutputPtr output = graph->addOutput();
+    output->setConnectedNode(constant);
+    REQUIRE(doc->getMatchingPorts(constant->getName()).front() == output);
+    output->setConnectedNode(nullptr);
+    REQUIRE(doc->getMatchingPorts(constant->getName()).empty());
+    output->setConnectedNode(constant);
+    graph->removeOutput(output->getName());
+    REQUIRE(doc->getMatchingPorts(constant->getName()).empty());
+
+    // Clearing the document empties the cache.
+    doc->initialize();
+    REQUIRE(doc->getMatchingNodeDefs("custom").empty());
+    REQUIRE(doc->getMatchingImplementations("ND_custom_float").empty());
+}
+
+TEST_CASE("Version upgrade", "[document]")
+{
+    // Element upgrades from v1.22 to v1.26 are applied together.
+    const std::string legacyDoc =
+        "<?xml version=\"1.0\"?>"
+        "<materialx version=\"1.22\">"
+        "  <nodegraph name=\"graph1\">"
+        "    <constant name=\"constant1\" type=\"vector\">"
+        "      <parameter name=\"color\" type=\"vector\" value=\"0.1, 0.2, 0.3\"/>"
+        "    </constant>"
+        "    <output name=\"out\" type=\"vector\" nodename=\"constant1\"/>"
+        "  </nodegraph>"
+        "</materialx>";
+    mx::DocumentPtr doc = mx::createDocument();
+    mx::readFromXmlString(doc, legacyDoc);
+    REQUIRE(doc->getVersionIntegers() == std::make_pair(MATERIALX_MAJOR_VERSION, MATERIALX_MINOR_VERSION));
+    mx::NodePtr constant = doc->getNodeGraph("graph1")->getNode("constant1");
+    REQUIRE(constant->getType() == "vector3");
+    REQUIRE(constant->getInput("value"));
+    REQUIRE(constant->getInput("value")->getType() == "vector3");
+    REQUIRE(doc->validate());
+
+    // Element upgrades from v1.34 to v1.35 follow the document upgrades.
+    const std::string olderDoc =
+        "<?xml version=\"1.0\"?>"
+        "<materialx version=\"1.34\">"
+        "  <nodedef name=\"ND_custom\" node=\"custom\" type=\"float\">"
+        "    <input name=\"xform\" type=\"matrix\" default=\"1,0,0,0, 0,1,0,0, 0,0,1,0, 0,0,0,1\"/>"
+        "  </nodedef>"
+        "  <look name=\"look1\">"
+        "    <materialassign name=\"mat1\" geom=\"/a\"/>"
+        "  </look>"
+        "</materialx>";
+    doc = mx::createDocument();
+    mx::readFromXmlString(doc, olderDoc);
+    mx::InputPtr xform = doc->getNodeDef("ND_custom")->getInput("xform");
+    REQUIRE(xform->getType() == "matrix44");
+    REQUIRE(xform->getValueString() == "1,0,0,0, 0,1,0,0, 0,0,1,0, 0,0,0,1");
+    REQUIRE(!xform->hasAttribute("default"));
+    REQUIRE(doc->getLook("look1")->getMaterialAssign("mat1")->getMaterial() == "mat1");
+
+    // Current documents are left untouched.
+    size_t epoch = doc->getModificationEpoch();
+    doc->upgradeVersion();
+    REQUIRE(doc->getModificationEpoch() == epoch);
+}
+
+TEST_CASE("Validation diagnostics", "[document]")
+{
+    mx::FileSearchPath searchPath = mx::getDefaultDataSearchPath();
+    mx::DocumentPtr libraries = mx::createDocument();
+    mx::loadLibraries({ "libraries" }, searchPath, libraries);
+
+    mx::DocumentPtr doc = mx::createDocument();
+    doc->importLibrary(libraries);
+    mx::NodeGraphPtr validGraph = doc->addNodeGraph("validGraph");
+    validGraph->addNode("constant", "constant1", "color3");
+    for (int i = 0; i < 3; i++)
+    {
+        doc->addNodeGraph("invalidGraph" + std::to_string(i))->setInheritString("missingGraph");
+    }
+    mx::NodeGraphPtr invalidGraph = doc->getNodeGraph("invalidGraph1");
+
+    // Each invalid element is reported with its path and the failed rule.
+    mx::ValidationDiagnosticVec serial;
+    REQUIRE(!doc->validateWithDiagnostics(serial));
+    REQUIRE(serial.size() == 3);
+    REQUIRE(serial[1].elementPath == invalidGraph->getNamePath());
+    REQUIRE(serial[1].rule == "element.inherit");
+    REQUIRE(serial[1].message.find("Invalid element inheritance") != std::string::npos);
+
+    // Parallel validation reports the same diagnostics in the same order.
+    mx::ValidationOptions options;
+    options.threadCount = 0;
+    mx::ValidationDiagnosticVec parallel;
+    REQUIRE(!doc->validateWithDiagnostics(parallel, &options));
+    REQUIRE(parallel.size() == serial.size());
+    for (size_t i = 0; i < serial.size(); i++)
+    {
+        REQUIRE(parallel[i].elementPath == serial[i].elementPath);
+        REQUIRE(parallel[i].rule == serial[i].rule);
+    }
+
+    // The number of reported diagnostics may be capped.
+    options.maxDiagnostics = 1;
+    mx::ValidationDiagnosticVec capped;
+    REQUIRE(!doc->validateWithDiagnostics(capped, &options));
+    REQUIRE(capped.size() == 1);
+    REQUIRE(capped[0].elementPath == serial[0].elementPath);
+
+    // Library elements that passed validation are revalidated only when
+    // library content changes.
+    options.maxDiagnostics = 0;
+    options.skipValidatedLibraryElements = true;
+    for (int pass = 0; pass < 2; pass++)
+    {
+        mx::ValidationDiagnosticVec skipped;
+        REQUIRE(!doc->validateWithDiagnostics(skipped, &options));
+        REQUIRE(skipped.size() == serial.size());
+    }
+
+    // Library elements referring to other content are always revalidated,
+    // so an edit to that content that invalidates one is reported.
+    mx::NodeDefPtr contentNodeDef = doc->addNodeDef("ND_content", "float", "content");
+    mx::NodeDefPtr skippedNodeDef = doc->getNodeDef("ND_image_float");
+    skippedNodeDef->setInheritString(contentNodeDef->getName());
+    mx::ValidationDiagnosticVec recorded;
+    REQUIRE(!doc->validateWithDiagnostics(recorded, &options));
+    REQUIRE(recorded.size() == serial.size());
+    doc->removeNodeDef(contentNodeDef->getName());
+    mx::ValidationDiagnosticVec revalidated;
+    REQUIRE(!doc->validateWithDiagnostics(revalidated, &options));
+    REQUIRE(revalidated.size() == serial.size() + 1);
+    bool reported = false;
+    for (const mx::ValidationDiagnostic& diagnostic : revalidated)
+    {
+        reported |= diagnostic.elementPath == skippedNodeDef->getNamePath();
+    }
+    REQUIRE(reported);
+    mx::ValidationDiagnosticVec unskipped;
+    REQUIRE(!doc->validateWithDiagnostics(unskipped));
+    REQUIRE(unskipped.size() == serial.size() + 1);
+    skippedNodeDef->removeAttribute(mx::Element::INHERIT_ATTRIBUTE);
+    validGraph->addNode("constant", "constant2", "float");
+    mx::NodeDefPtr libraryNodeDef = doc->getNodeDef("ND_image_color3");
+    REQUIRE(libraryNodeDef->hasSourceUri());
+    libraryNodeDef->setInheritString("ND_missing");
+    mx::ValidationDiagnosticVec edited;
+    REQUIRE(!doc->validateWithDiagnostics(edited, &options));
+    REQUIRE(edited.size() == serial.size() + 1);
+    REQUIRE(edited[0].elementPath == libraryNodeDef->getNamePath());
+
+    // Without errors, validation succeeds and reports no diagnostics.
+    libraryNodeDef->removeAttribute(mx::Element::INHERIT_ATTRIBUTE);
+    for (int i = 0; i < 3; i++)
+    {
+        doc->removeNodeGraph("invalidGraph" + std::to_string(i));
+    }
+    mx::ValidationDiagnosticVec none;
+    REQUIRE(doc->validateWithDiagnostics(none, &options));
+    REQUIRE(none.empty());
+    REQUIRE(doc->validate());
+}
@@ -69,3 +69,35 @@ TEST_CASE("Element", "[element]")
     }
     REQUIRE_THROWS_AS(orphan->getDocument(), mx::ExceptionOrphanedElement);
 }
+
+TEST_CASE("Value element cache", "[element]")
+{
+    mx::DocumentPtr doc = mx::createDocument();
+    mx::NodeGraphPtr nodeGraph = doc->addNodeGraph();
+    mx::NodePtr constant = nodeGraph->addNode("constant");
+    mx::InputPtr input = constant->setInputValue("value", 0.5f);
+
+    // Repeated access returns the cached value.
+    mx::ValuePtr value = input->getValue();
+    REQUIRE(value->asA<float>() == 0.5f);
+    REQUIRE(input->getValue() == value);
+    REQUIRE(input->getResolvedValue() == value);
+
+    // Changes to the value or type string invalidate the cache.
+    input->setValueString("0.25");
+    REQUIRE(input->getValue()->asA<float>() == 0.25f);
+    input->setType("color3");
+    input->setValueString("1, 0, 0");
+    REQUIRE(input->getValue()->asA<mx::Color3>() == mx::Color3(1, 0, 0));
+    input->setType("vector3");
+    REQUIRE(input->getValue()->isA<mx::Vector3>());
+    input->removeAttribute(mx::ValueElement::VALUE_ATTRIBUTE);
+    REQUIRE(!input->getValue());
+
+    // Copied content is reparsed.
+    mx::InputPtr input2 = constant->addInput("in2", "float");
+    input2->setValue(1.0f);
+    REQUIRE(input2->getValue()->asA<float>() == 1.0f);
+    input2->copyContentFrom(constant->setInputValue("in3", 2.0f));
+    REQUIRE(input2->getValue()->asA<float>() == 2.0f);
+}
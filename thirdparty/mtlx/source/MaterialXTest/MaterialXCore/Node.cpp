@@ -154,6 +154,50 @@ TEST_CASE("Node inputCount repro", "[node]")
     CHECK(doc->validate());
 }
 
+TEST_CASE("Node definition cache", "[node]")
+{
+    mx::DocumentPtr doc = mx::createDocument();
+    mx::NodeDefPtr nodeDef = doc->addNodeDef("ND_custom_float", "float", "custom");
+    nodeDef->setInputValue("in", 0.0f);
+    mx::NodePtr node = doc->addNode("custom", "node1", "float");
+    node->setInputValue("in", 1.0f);
+
+    // Repeated resolutions are served from the cache.
+    size_t misses = doc->getNodeDefCacheMisses();
+    REQUIRE(node->getNodeDef() == nodeDef);
+    REQUIRE(node->getNodeDef() == nodeDef);
+    REQUIRE(node->getNodeDef() == nodeDef);
+    REQUIRE(doc->getNodeDefCacheMisses() == misses + 1);
+    REQUIRE(doc->getNodeDefCacheHits() >= 2);
+
+    // Each target is cached separately.
+    REQUIRE(node->getNodeDef("genglsl") == nodeDef);
+    REQUIRE(doc->getNodeDefCacheMisses() == misses + 2);
+    REQUIRE(node->getNodeDef("genglsl") == nodeDef);
+    REQUIRE(node->getNodeDef() == nodeDef);
+    REQUIRE(doc->getNodeDefCacheMisses() == misses + 2);
+
+    // Edits anywhere in the document invalidate the cache.
+    nodeDef->setTarget("genosl");
+    REQUIRE(node->getNodeDef("genglsl") == nullptr);
+    nodeDef->removeAttribute(mx::InterfaceElement::TARGET_ATTRIBUTE);
+    REQUIRE(node->getNodeDef("genglsl") == nodeDef);
+    node->setInputValue("extra", 1.0f);
+    REQUIRE(node->getNodeDef() == nullptr);
+    REQUIRE(node->getNodeDef("", true) == nodeDef);
+    node->removeInput("extra");
+    REQUIRE(node->getNodeDef() == nodeDef);
+
+    // Edits to a data library invalidate the cache of documents referencing it.
+    mx::DocumentPtr lib = mx::createDocument();
+    mx::NodeDefPtr libNodeDef = lib->addNodeDef("ND_libnode_float", "float", "libnode");
+    doc->setDataLibrary(lib);
+    mx::NodePtr libNode = doc->addNode("libnode", "node2", "float");
+    REQUIRE(libNode->getNodeDef() == libNodeDef);
+    libNodeDef->setNodeString("libnode2");
+    REQUIRE(libNode->getNodeDef() == nullptr);
+}
+
 TEST_CASE("Flatten", "[nodegraph]")
 {
     // Read an example containing graph-based custom nodes.
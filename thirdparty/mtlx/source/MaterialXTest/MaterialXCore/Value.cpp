@@ -8,6 +8,10 @@
 #include <MaterialXCore/Util.h>
 #include <MaterialXCore/Value.h>
 
+#include <limits>
+#include <random>
+#include <sstream>
+
 namespace mx = MaterialX;
 
 template<class T> void testTypedValue(const T& v1, const T& v2)
@@ -40,6 +44,15 @@ template<class T> void testTypedValue(const T& v1, const T& v2)
     REQUIRE(newValue2->asA<T>() == v2);
 }
 
+template <class T> T parseWithStream(const std::string& str)
+{
+    std::stringstream ss(str);
+    ss.imbue(std::locale::classic());
+    T data{};
+    ss >> data;
+    return data;
+}
+
 TEST_CASE("Value strings", "[value]")
 {
     // Convert from data values to value strings.
@@ -78,6 +91,49 @@ TEST_CASE("Value strings", "[value]")
     REQUIRE_THROWS_AS(mx::fromValueString<float>("text"), mx::ExceptionTypeError);
     REQUIRE_THROWS_AS(mx::fromValueString<bool>("1"), mx::ExceptionTypeError);
     REQUIRE_THROWS_AS(mx::fromValueString<mx::Color3>("1"), mx::ExceptionTypeError);
+    REQUIRE_THROWS_AS(mx::fromValueString<mx::Color3>("1, 1, 1, 1"), mx::ExceptionTypeError);
+    REQUIRE_THROWS_AS(mx::fromValueString<mx::Matrix33>("1, 0, 0, 0, 1, 0, 0, 0"), mx::ExceptionTypeError);
+    REQUIRE_THROWS_AS(mx::fromValueString<int>("99999999999"), mx::ExceptionTypeError);
+    REQUIRE_THROWS_AS(mx::fromValueString<float>("1e99"), mx::ExceptionTypeError);
+    REQUIRE_THROWS_AS(mx::fromValueString<mx::FloatVec>("1, , 2"), mx::ExceptionTypeError);
+
+    // Verify that parsing matches stream extraction in the classic locale.
+    for (const char* str : { "0", "-0", "+7", " 12", "3.", ".5", "-0.125", "1e3", "2.5E-4",
+                             "1.17549435e-38", "3.40282347e+38", "0.1", "0.123456789",
+                             "16777217", "1.5abc", "123456789012345678901234567890" })
+    {
+        REQUIRE(mx::fromValueString<float>(str) == parseWithStream<float>(str));
+        REQUIRE(mx::fromValueString<double>(str) == parseWithStream<double>(str));
+    }
+    for (const char* str : { "0", "-0", "+7", " 12", "2147483647", "-2147483648", "3.7", "42abc" })
+    {
+        REQUIRE(mx::fromValueString<int>(str) == parseWithStream<int>(str));
+    }
+    REQUIRE(mx::fromValueString<mx::Matrix44>("1 0 0 0, 0 2 0 0, 0 0 3 0, 4 5 6 1") ==
+            mx::Matrix44(1, 0, 0, 0, 0, 2, 0, 0, 0, 0, 3, 0, 4, 5, 6, 1));
+    REQUIRE(mx::fromValueString<mx::IntVec>("1, -2 ,3") == (mx::IntVec{ 1, -2, 3 }));
+    REQUIRE(mx::fromValueString<mx::FloatVec>(" 0.5,1e1 ") == (mx::FloatVec{ 0.5f, 10.0f }));
+
+    // Verify that formatted values round-trip through parsing.
+    std::mt19937 rng(0);
+    std::uniform_real_distribution<float> dist(-1000.0f, 1000.0f);
+    for (int i = 0; i < 1000; i++)
+    {
+        float value = dist(rng);
+        {
+            mx::ScopedFloatFormatting fmt(mx::Value::FloatFormatDefault, std::numeric_limits<float>::max_digits10);
+            REQUIRE(mx::fromValueString<float>(mx::toValueString(value)) == value);
+        }
+        for (mx::Value::FloatFormat format : { mx::Value::FloatFormatDefault, mx::Value::FloatFormatFixed, mx::Value::FloatFormatScientific })
+        {
+            mx::ScopedFloatFormatting fmt(format, 4);
+            mx::Vector3 vec(value, -value, value * 0.001f);
+            mx::Vector3 expected(parseWithStream<float>(mx::toValueString(vec[0])),
+                                 parseWithStream<float>(mx::toValueString(vec[1])),
+                                 parseWithStream<float>(mx::toValueString(vec[2])));
+            REQUIRE(mx::fromValueString<mx::Vector3>(mx::toValueString(vec)) == expected);
+        }
+    }
 }
 
 TEST_CASE("Typed values", "[value]")
@@ -122,3 +178,21 @@ TEST_CASE("Typed values", "[value]")
     REQUIRE(value->isA<std::string>());
     REQUIRE(value->asA<std::string>() == "text");
 }
+
+#ifdef MATERIALX_BUILD_BENCHMARK_TESTS
+TEST_CASE("Value parsing", "[value]")
+{
+    BENCHMARK("Parse float")
+    {
+        return mx::fromValueString<float>("0.718");
+    };
+    BENCHMARK("Parse color3")
+    {
+        return mx::fromValueString<mx::Color3>("0.8, 0.8, 0.8");
+    };
+    BENCHMARK("Parse matrix44")
+    {
+        return mx::fromValueString<mx::Matrix44>("1, 0, 0, 0, 0, 1, 0, 0, 0, 0, 1, 0, 0.5, 0.25, 0.125, 1");
+    };
+}
+#endif
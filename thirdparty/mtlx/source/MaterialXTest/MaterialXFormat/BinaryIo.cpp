@@ -0,0 +1,139 @@
+//
+// Copyright Contributors to the MaterialX Project
+// SPDX-License-Identifier: Apache-2.0
+//
+
+#include <MaterialXTest/External/Catch/catch.hpp>
+
+#include <MaterialXFormat/BinaryIo.h>
+#include <MaterialXFormat/Environ.h>
+#include <MaterialXFormat/Util.h>
+
+#include <cstdio>
+
+namespace mx = MaterialX;
+
+namespace
+{
+
+// Return a directory for files written by these tests.
+mx::FilePath getTempDirectory()
+{
+    for (const char* name : { "TMPDIR", "TEMP", "TMP" })
+    {
+        std::string dir = mx::getEnviron(name);
+        if (!dir.empty())
+        {
+            return dir;
+        }
+    }
+    return "/tmp";
+}
+
+} // anonymous namespace
+
+TEST_CASE("Binary round trip", "[binaryio]")
+{
+    mx::FileSearchPath searchPath = mx::getDefaultDataSearchPath();
+    mx::FilePath examplesPath = searchPath.find("resources/Materials/Examples/StandardSurface");
+
+    mx::XmlReadOptions readOptions;
+    readOptions.readComments = true;
+    readOptions.readNewlines = true;
+
+    for (const mx::FilePath& filename : examplesPath.getFilesInDirectory(mx::MTLX_EXTENSION))
+    {
+        mx::DocumentPtr doc = mx::createDocument();
+        mx::readFromXmlFile(doc, examplesPath / filename, searchPath, &readOptions);
+
+        // A document read back from a snapshot writes the same XML.
+        mx::DocumentPtr snapshotDoc = mx::createDocument();
+        mx::readFromBinaryString(snapshotDoc, mx::writeToBinaryString(doc));
+        REQUIRE(mx::writeToXmlString(snapshotDoc) == mx::writeToXmlString(doc));
+        REQUIRE(snapshotDoc->getSourceUri() == doc->getSourceUri());
+        REQUIRE(*snapshotDoc == *doc);
+    }
+
+    // Elements imported from libraries keep their source URIs.
+    mx::DocumentPtr libraries = mx::createDocument();
+    mx::loadLibraries({ "libraries" }, searchPath, libraries);
+    mx::FilePath snapshotPath = getTempDirectory() / ("libraries_snapshot." + mx::MTLX_BINARY_EXTENSION);
+    mx::writeToBinaryFile(libraries, snapshotPath);
+    mx::DocumentPtr snapshotLibraries = mx::createDocument();
+    mx::readFromBinaryFile(snapshotLibraries, snapshotPath);
+    std::remove(snapshotPath.asString().c_str());
+    REQUIRE(!snapshotPath.exists());
+    REQUIRE(mx::writeToXmlString(snapshotLibraries) == mx::writeToXmlString(libraries));
+    REQUIRE(snapshotLibraries->getNodeDefs().size() == libraries->getNodeDefs().size());
+    REQUIRE(snapshotLibraries->getMatchingNodeDefs("image").size() == libraries->getMatchingNodeDefs("image").size());
+    REQUIRE(snapshotLibraries->validate());
+}
+
+TEST_CASE("Binary parse errors", "[binaryio]")
+{
+    mx::DocumentPtr doc = mx::createDocument();
+    mx::NodeGraphPtr nodeGraph = doc->addNodeGraph();
+    nodeGraph->addNode("constant", "constant1", "color3")->setInputValue("value", mx::Color3(0.5f));
+    std::string snapshot = mx::writeToBinaryString(doc);
+
+    // Truncated and foreign data is rejected.
+    for (size_t size = 0; size < snapshot.size(); size++)
+    {
+        mx::DocumentPtr truncatedDoc = mx::createDocument();
+        REQUIRE_THROWS_AS(mx::readFromBinaryString(truncatedDoc, snapshot.substr(0, size)), mx::ExceptionParseError);
+    }
+    REQUIRE_THROWS_AS(mx::readFromBinaryString(mx::createDocument(), mx::writeToXmlString(doc)), mx::ExceptionParseError);
+    REQUIRE_THROWS_AS(mx::readFromBinaryString(mx::createDocument(), snapshot + '\0'), mx::ExceptionParseError);
+    REQUIRE_THROWS_AS(mx::readFromBinaryFile(mx::createDocument(), "missing." + mx::MTLX_BINARY_EXTENSION), mx::ExceptionFileMissing);
+
+    // Elements without a category are rejected.
+    mx::DocumentPtr emptyCategoryDoc = mx::createDocument();
+    emptyCategoryDoc->addNodeGraph("graph1")->addChildOfCategory("", "uncategorized");
+    std::string emptyCategorySnapshot = mx::writeToBinaryString(emptyCategoryDoc);
+    REQUIRE_THROWS_AS(mx::readFromBinaryString(mx::createDocument(), emptyCategorySnapshot), mx::ExceptionParseError);
+    for (size_t size = 0; size < emptyCategorySnapshot.size(); size++)
+    {
+        REQUIRE_THROWS_AS(mx::readFromBinaryString(mx::createDocument(), emptyCategorySnapshot.substr(0, size)), mx::ExceptionParseError);
+    }
+
+    // Deeply nested elements are read without recursion, whether they are
+    // added or skipped.
+    mx::DocumentPtr deepDoc = mx::createDocument();
+    mx::ElementPtr elem = deepDoc;
+    for (int i = 0; i < 1000; i++)
+    {
+        elem = elem->addChildOfCategory("generic", "level");
+    }
+    std::string deepSnapshot = mx::writeToBinaryString(deepDoc);
+    mx::DocumentPtr deepSnapshotDoc = mx::createDocument();
+    mx::readFromBinaryString(deepSnapshotDoc, deepSnapshot);
+    REQUIRE(mx::writeToXmlString(deepSnapshotDoc) == mx::writeToXmlString(deepDoc));
+    mx::DocumentPtr existingDoc = mx::createDocument();
+    existingDoc->addChildOfCategory("generic", "level");
+    mx::readFromBinaryString(existingDoc, deepSnapshot);
+    REQUIRE(existingDoc->getChildren().size() == 1);
+    REQUIRE(existingDoc->getChildren()[0]->getChildren().empty());
+}
+
+#ifdef MATERIALX_BUILD_BENCHMARK_TESTS
+TEST_CASE("Load standard library snapshot", "[binaryio]")
+{
+    mx::FileSearchPath searchPath = mx::getDefaultDataSearchPath();
+    mx::DocumentPtr libraries = mx::createDocument();
+    mx::loadLibraries({ "libraries" }, searchPath, libraries);
+    std::string snapshot = mx::writeToBinaryString(libraries);
+
+    BENCHMARK("Load standard libraries from XML")
+    {
+        mx::DocumentPtr doc = mx::createDocument();
+        mx::loadLibraries({ "libraries" }, searchPath, doc);
+        return doc->getMatchingNodeDefs("image").size();
+    };
+    BENCHMARK("Load standard libraries from a binary snapshot")
+    {
+        mx::DocumentPtr doc = mx::createDocument();
+        mx::readFromBinaryString(doc, snapshot);
+        return doc->getMatchingNodeDefs("image").size();
+    };
+}
+#endif
@@ -8,6 +8,16 @@
 #include <MaterialXFormat/File.h>
 #include <MaterialXFormat/Util.h>
 
+#include <cstdio>
+#include <fstream>
+
+#if defined(_WIN32)
+    #include <direct.h>
+    #define rmdir _rmdir
+#else
+    #include <unistd.h>
+#endif
+
 namespace mx = MaterialX;
 
 TEST_CASE("Syntactic operations", "[file]")
@@ -67,6 +77,55 @@ TEST_CASE("File search path operations", "[file]")
     }
 }
 
+TEST_CASE("File system cache", "[file]")
+{
+    mx::FilePath testDir = mx::FilePath::getCurrentPath() / "fileSystemCacheTest";
+    testDir.createDirectory();
+    mx::FilePath testFile = testDir / "cached.mtlx";
+    std::remove(testFile.asString().c_str());
+
+    mx::FileSearchPath searchPath(testDir);
+    mx::FileSystemCachePtr cache = mx::FileSystemCache::create();
+    searchPath.setFileSystemCache(cache);
+    REQUIRE(cache->isDirectory(testDir));
+    REQUIRE(searchPath.find("cached.mtlx") == "cached.mtlx");
+    REQUIRE(searchPath.getFilesInDirectory(testDir, mx::MTLX_EXTENSION).empty());
+
+    // Results are reused until the cache is invalidated.
+    std::ofstream(testFile.asString()) << "<materialx/>";
+    REQUIRE(testFile.exists());
+    REQUIRE(!cache->exists(testFile));
+    REQUIRE(searchPath.find("cached.mtlx") == "cached.mtlx");
+    REQUIRE(searchPath.getFilesInDirectory(testDir, mx::MTLX_EXTENSION).empty());
+    cache->invalidate(testFile);
+    REQUIRE(searchPath.find("cached.mtlx") == testFile);
+    REQUIRE(searchPath.getFilesInDirectory(testDir, mx::MTLX_EXTENSION) == mx::FilePathVec{ "cached.mtlx" });
+
+    // Copies and extensions of a search path share its cache.
+    mx::FileSearchPath extendedPath;
+    extendedPath.append(searchPath);
+    REQUIRE(extendedPath.getFileSystemCache() == cache);
+    std::remove(testFile.asString().c_str());
+    REQUIRE(extendedPath.find("cached.mtlx") == testFile);
+    cache->clear();
+    REQUIRE(extendedPath.find("cached.mtlx") == "cached.mtlx");
+
+    // Libraries load identically through a cache.
+    mx::FileSearchPath libraryPath = mx::getDefaultDataSearchPath();
+    mx::DocumentPtr doc = mx::createDocument();
+    mx::StringSet files = mx::loadLibraries({ "libraries" }, libraryPath, doc);
+    libraryPath.setFileSystemCache(cache);
+    for (int i = 0; i < 2; i++)
+    {
+        mx::DocumentPtr cachedDoc = mx::createDocument();
+        REQUIRE(mx::loadLibraries({ "libraries" }, libraryPath, cachedDoc) == files);
+        REQUIRE(*cachedDoc == *doc);
+    }
+
+    rmdir(testDir.asString().c_str());
+    REQUIRE(!testDir.exists());
+}
+
 TEST_CASE("Flatten filenames", "[file]")
 {
     const mx::FilePath TEST_FILE_PREFIX_STRING("resources\\Images\\");
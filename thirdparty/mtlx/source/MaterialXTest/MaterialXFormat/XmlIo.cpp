@@ -239,6 +239,26 @@ TEST_CASE("Load content", "[xmlio]")
     REQUIRE_THROWS_AS(mx::readFromXmlFile(nonExistentDoc, "NonExistent.mtlx", mx::FileSearchPath(), &readOptions), mx::ExceptionFileMissing);
 }
 
+TEST_CASE("Load libraries in parallel", "[xmlio]")
+{
+    mx::FileSearchPath searchPath = mx::getDefaultDataSearchPath();
+    mx::FilePathVec libraryFolders = { "libraries" };
+
+    mx::DocumentPtr sequentialDoc = mx::createDocument();
+    mx::StringSet sequentialFiles = mx::loadLibraries(libraryFolders, searchPath, sequentialDoc);
+    REQUIRE(!sequentialFiles.empty());
+
+    // The result of a threaded load is identical to a sequential one.
+    for (unsigned int threadCount : { 0u, 2u, 8u })
+    {
+        mx::DocumentPtr parallelDoc = mx::createDocument();
+        mx::StringSet parallelFiles = mx::loadLibraries(libraryFolders, searchPath, parallelDoc,
+                                                        mx::StringSet(), nullptr, threadCount);
+        REQUIRE(parallelFiles == sequentialFiles);
+        REQUIRE(*parallelDoc == *sequentialDoc);
+    }
+}
+
 TEST_CASE("Comments and newlines", "[xmlio]")
 {
     mx::FileSearchPath searchPath = mx::getDefaultDataSearchPath();
@@ -348,3 +368,30 @@ TEST_CASE("Locale region testing", "[xmlio]")
     // Restore the original locale.
     std::locale::global(origLocale);
 }
+
+#ifdef MATERIALX_BUILD_BENCHMARK_TESTS
+TEST_CASE("Load standard libraries", "[xmlio]")
+{
+    mx::FileSearchPath searchPath = mx::getDefaultDataSearchPath();
+    BENCHMARK("Load standard libraries and look up definitions")
+    {
+        mx::DocumentPtr doc = mx::createDocument();
+        mx::loadLibraries({ "libraries" }, searchPath, doc);
+        return doc->getMatchingNodeDefs("image").size();
+    };
+    BENCHMARK("Load standard libraries on all hardware threads")
+    {
+        mx::DocumentPtr doc = mx::createDocument();
+        mx::loadLibraries({ "libraries" }, searchPath, doc, mx::StringSet(), nullptr, 0);
+        return doc->getMatchingNodeDefs("image").size();
+    };
+    BENCHMARK("Load standard libraries without version upgrades")
+    {
+        mx::XmlReadOptions readOptions;
+        readOptions.upgradeVersion = false;
+        mx::DocumentPtr doc = mx::createDocument();
+        mx::loadLibraries({ "libraries" }, searchPath, doc, mx::StringSet(), &readOptions);
+        return doc->getMatchingNodeDefs("image").size();
+    };
+}
+#endif
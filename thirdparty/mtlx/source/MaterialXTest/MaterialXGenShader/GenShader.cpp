@@ -12,7 +12,9 @@
 #include <MaterialXFormat/Util.h>
 
 #include <MaterialXGenShader/HwShaderGenerator.h>
+#include <MaterialXGenShader/ShaderCache.h>
 #include <MaterialXGenShader/ShaderTranslator.h>
+#include <MaterialXGenShader/SourceCache.h>
 #include <MaterialXGenShader/Util.h>
 
 #ifdef MATERIALX_BUILD_GEN_GLSL
@@ -28,10 +30,14 @@
 #include <MaterialXGenMsl/MslShaderGenerator.h>
 #endif
 
+#include <chrono>
+#include <cstdio>
 #include <cstdlib>
+#include <fstream>
 #include <iostream>
 #include <vector>
 #include <set>
+#include <thread>
 
 namespace mx = MaterialX;
 
@@ -416,3 +422,403 @@ TEST_CASE("GenShader: Track Application Variables", "[genshader]")
     }
 #endif
 }
+
+TEST_CASE("GenShader: Source Cache", "[genshader]")
+{
+    mx::SourceCachePtr cache = mx::SourceCache::create();
+    mx::FilePath sourcePath = "source_cache_test.glsl";
+    {
+        std::ofstream file(sourcePath.asString());
+        file << "void first()\n{\n}\n";
+    }
+
+    // Files are read from disk only on first use.
+    mx::ConstSourceFilePtr source = cache->getFile(sourcePath);
+    REQUIRE(source);
+    REQUIRE(source->getLines().size() == 3);
+    REQUIRE(source->getLines()[0] == "void first()");
+    REQUIRE(cache->getFile(sourcePath) == source);
+    REQUIRE(cache->getCacheMisses() == 1);
+    REQUIRE(cache->getCacheHits() == 1);
+
+    // Files modified on disk are read again, even within the timestamp
+    // resolution of the file system when their length changes.
+    {
+        std::ofstream file(sourcePath.asString());
+        file << "void second_function()\n{\n}\n";
+    }
+    mx::ConstSourceFilePtr modified = cache->getFile(sourcePath);
+    REQUIRE(modified);
+    REQUIRE(modified->getLines()[0] == "void second_function()");
+    REQUIRE(cache->getCacheMisses() == 2);
+
+    // Missing files are reported as such.
+    REQUIRE(!cache->getFile("missing_source_file.glsl"));
+    std::remove(sourcePath.asString().c_str());
+
+#ifdef MATERIALX_BUILD_GEN_GLSL
+    // Repeated generation is served from the shared cache.
+    mx::FileSearchPath searchPath = mx::getDefaultDataSearchPath();
+    mx::DocumentPtr libraries = mx::createDocument();
+    mx::loadLibraries({ "libraries" }, searchPath, libraries);
+    mx::DocumentPtr doc = mx::createDocument();
+    mx::readFromXmlFile(doc, searchPath.find("resources/Materials/Examples/StandardSurface/standard_surface_default.mtlx"));
+    doc->importLibrary(libraries);
+    mx::ElementPtr element = doc->getChild("SR_default");
+    REQUIRE(element);
+
+    std::string shaderCode;
+    for (int i = 0; i < 2; i++)
+    {
+        mx::GenContext context(mx::GlslShaderGenerator::create());
+        context.registerSourceCodeSearchPath(searchPath);
+        size_t misses = mx::SourceCache::getInstance()->getCacheMisses();
+        mx::ShaderPtr shader = context.getShaderGenerator().generate("test_shader", element, context);
+        REQUIRE(shader);
+        if (i == 0)
+        {
+            shaderCode = shader->getSourceCode(mx::Stage::PIXEL);
+        }
+        else
+        {
+            REQUIRE(shader->getSourceCode(mx::Stage::PIXEL) == shaderCode);
+            REQUIRE(mx::SourceCache::getInstance()->getCacheMisses() == misses);
+        }
+    }
+    REQUIRE(mx::SourceCache::getInstance()->getCacheHits() > 0);
+#endif
+}
+
+void testParallelGeneration(mx::DocumentPtr libraries, mx::GenContext& context, mx::ShaderGeneratorFactory factory)
+{
+    mx::FileSearchPath searchPath = mx::getDefaultDataSearchPath();
+    mx::FilePath examplesPath = searchPath.find("resources/Materials/Examples/StandardSurface");
+
+    std::vector<mx::DocumentPtr> docs;
+    std::vector<mx::TypedElementPtr> elements;
+    for (const mx::FilePath& filename : examplesPath.getFilesInDirectory(mx::MTLX_EXTENSION))
+    {
+        mx::DocumentPtr doc = mx::createDocument();
+        mx::readFromXmlFile(doc, examplesPath / filename, searchPath);
+        doc->importLibrary(libraries);
+        docs.push_back(doc);
+        for (mx::TypedElementPtr elem : mx::findRenderableElements(doc))
+        {
+            elements.push_back(elem);
+        }
+    }
+    REQUIRE(elements.size() > 4);
+
+    // Generate each shader serially from a standalone context.
+    std::vector<std::string> serialCode;
+    for (mx::TypedElementPtr elem : elements)
+    {
+        mx::ShaderPtr shader = context.getShaderGenerator().generate(elem->getName(), elem, context);
+        serialCode.push_back(shader->getSourceCode(mx::Stage::PIXEL));
+    }
+
+    // Shaders generated in parallel from a shared core match the serial results.
+    mx::GenContextCorePtr core = mx::GenContextCore::create(factory, context);
+    std::vector<mx::ShaderPtr> shaders = core->generateAll(elements, 4);
+    REQUIRE(shaders.size() == elements.size());
+    for (size_t i = 0; i < shaders.size(); i++)
+    {
+        REQUIRE(shaders[i]);
+        REQUIRE(shaders[i]->getSourceCode(mx::Stage::PIXEL) == serialCode[i]);
+    }
+
+    // Shareable implementations are cached once in the core.
+    mx::StringSet coreNames;
+    core->getNodeImplementationNames(coreNames);
+    REQUIRE(!coreNames.empty());
+    mx::GenContext context1(core);
+    mx::GenContext context2(core);
+    REQUIRE(&context1.getShaderGenerator() != &context2.getShaderGenerator());
+    const std::string& implName = *coreNames.begin();
+    REQUIRE(context1.findNodeImplementation(implName) == context2.findNodeImplementation(implName));
+    REQUIRE(context1.findNodeImplementation(implName)->isShareable());
+
+    // Errors are reported for the first failing element.
+    mx::DocumentPtr badDoc = mx::createDocument();
+    mx::NodePtr badNode = badDoc->addNode("unknown_node", "bad", mx::SURFACE_SHADER_TYPE_STRING);
+    std::vector<mx::TypedElementPtr> badElements = { elements[0], badNode };
+    REQUIRE_THROWS_AS(core->generateAll(badElements, 2), mx::ExceptionShaderGenError);
+}
+
+TEST_CASE("GenShader: Parallel Generation", "[genshader]")
+{
+    mx::FileSearchPath searchPath = mx::getDefaultDataSearchPath();
+    mx::DocumentPtr libraries = mx::createDocument();
+    mx::loadLibraries({ "libraries" }, searchPath, libraries);
+
+#ifdef MATERIALX_BUILD_GEN_GLSL
+    {
+        mx::GenContext context(mx::GlslShaderGenerator::create());
+        context.registerSourceCodeSearchPath(searchPath);
+        testParallelGeneration(libraries, context, mx::GlslShaderGenerator::create);
+    }
+#endif
+#ifdef MATERIALX_BUILD_GEN_OSL
+    {
+        mx::GenContext context(mx::OslShaderGenerator::create());
+        context.registerSourceCodeSearchPath(searchPath);
+        testParallelGeneration(libraries, context, mx::OslShaderGenerator::create);
+    }
+#endif
+}
+
+#ifdef MATERIALX_BUILD_GEN_GLSL
+TEST_CASE("GenShader: Shader Cache", "[genshader]")
+{
+    mx::FileSearchPath searchPath = mx::getDefaultDataSearchPath();
+    mx::DocumentPtr libraries = mx::createDocument();
+    mx::loadLibraries({ "libraries" }, searchPath, libraries);
+    mx::FilePath examplesPath = searchPath.find("resources/Materials/Examples/StandardSurface");
+
+    std::vector<mx::DocumentPtr> docs;
+    std::vector<mx::TypedElementPtr> elements;
+    for (const mx::FilePath& filename : examplesPath.getFilesInDirectory(mx::MTLX_EXTENSION))
+    {
+        mx::DocumentPtr doc = mx::createDocument();
+        mx::readFromXmlFile(doc, examplesPath / filename, searchPath);
+        doc->importLibrary(libraries);
+        docs.push_back(doc);
+        for (mx::TypedElementPtr elem : mx::findRenderableElements(doc))
+        {
+            elements.push_back(elem);
+        }
+    }
+
+    mx::GenContext context(mx::GlslShaderGenerator::create());
+    context.registerSourceCodeSearchPath(searchPath);
+    mx::ShaderCachePtr cache = mx::ShaderCache::create();
+    for (mx::TypedElementPtr elem : elements)
+    {
+        mx::UniformValueMap uniformValues;
+        mx::ShaderPtr shader = cache->getShader(elem->getName(), elem, context, uniformValues);
+        REQUIRE(shader);
+
+        // The uniforms of the cached shader take the values of this element,
+        // matching those of a shader generated for the element alone.
+        mx::ShaderPtr expected = context.getShaderGenerator().generate(elem->getName(), elem, context);
+        const mx::VariableBlock& uniforms = shader->getStage(mx::Stage::PIXEL).getUniformBlock(mx::HW::PUBLIC_UNIFORMS);
+        const mx::VariableBlock& expectedUniforms = expected->getStage(mx::Stage::PIXEL).getUniformBlock(mx::HW::PUBLIC_UNIFORMS);
+        REQUIRE(uniforms.size() == expectedUniforms.size());
+        for (size_t i = 0; i < uniforms.size(); i++)
+        {
+            REQUIRE(uniforms[i]->getType() == expectedUniforms[i]->getType());
+            auto it = uniformValues.find(uniforms[i]->getVariable());
+            std::string value = it != uniformValues.end() ? it->second->getValueString() : std::string();
+            REQUIRE(value == expectedUniforms[i]->getValueString());
+        }
+    }
+
+    // Materials sharing the standard_surface network share a shader.
+    REQUIRE(cache->getShaderCount() < elements.size());
+    REQUIRE(cache->getCacheHits() + cache->getCacheMisses() == elements.size());
+    REQUIRE(cache->getCacheMisses() == cache->getShaderCount());
+
+    // A change of generation options selects a different shader.
+    mx::UniformValueMap uniformValues;
+    mx::ShaderPtr opaqueShader = cache->getShader(elements[0]->getName(), elements[0], context, uniformValues);
+    context.getOptions().hwTransparency = !context.getOptions().hwTransparency;
+    mx::ShaderPtr transparentShader = cache->getShader(elements[0]->getName(), elements[0], context, uniformValues);
+    REQUIRE(opaqueShader != transparentShader);
+
+    // A change of a constant input value selects a different shader, while
+    // a change of a uniform input value does not.
+    mx::DocumentPtr doc = mx::createDocument();
+    doc->importLibrary(libraries);
+    mx::NodePtr constant = doc->addNode("constant", "constant1", "color3");
+    constant->setInputValue("value", mx::Color3(0.1f, 0.2f, 0.3f));
+    mx::NodePtr shaderNode = doc->addNode("standard_surface", "surface1", mx::SURFACE_SHADER_TYPE_STRING);
+    shaderNode->setConnectedNode("base_color", constant);
+    shaderNode->setInputValue("base", 0.5f);
+    mx::ShaderPtr firstShader = cache->getShader(shaderNode->getName(), shaderNode, context, uniformValues);
+    shaderNode->setInputValue("base", 0.25f);
+    REQUIRE(cache->getShader(shaderNode->getName(), shaderNode, context, uniformValues) == firstShader);
+    REQUIRE(uniformValues.count("base"));
+    REQUIRE(uniformValues["base"]->asA<float>() == 0.25f);
+    context.getOptions().shaderInterfaceType = mx::SHADER_INTERFACE_REDUCED;
+    mx::ShaderPtr reducedShader = cache->getShader(shaderNode->getName(), shaderNode, context, uniformValues);
+    constant->setInputValue("value", mx::Color3(0.4f, 0.5f, 0.6f));
+    REQUIRE(cache->getShader(shaderNode->getName(), shaderNode, context, uniformValues) != reducedShader);
+
+    // Implementations of the same name from different documents select
+    // different shaders when their source code differs.
+    std::vector<mx::ShaderPtr> customShaders;
+    for (const std::string& sourceCode : mx::StringVec{ "{{in}} * 2.0", "{{in}} * 3.0" })
+    {
+        mx::DocumentPtr customDoc = mx::createDocument();
+        customDoc->importLibrary(libraries);
+        mx::NodeDefPtr nodeDef = customDoc->addNodeDef("ND_custom_color3", "color3", "custom");
+        nodeDef->setInputValue("in", mx::Color3(0.5f));
+        mx::ImplementationPtr impl = customDoc->addImplementation("IM_custom_color3_genglsl");
+        impl->setNodeDef(nodeDef);
+        impl->setTarget(mx::GlslShaderGenerator::TARGET);
+        impl->setAttribute("sourcecode", sourceCode);
+        mx::NodePtr customNode = customDoc->addNode("custom", "custom1", "color3");
+        mx::NodePtr customSurface = customDoc->addNode("standard_surface", "surface1", mx::SURFACE_SHADER_TYPE_STRING);
+        customSurface->setConnectedNode("base_color", customNode);
+
+        mx::GenContext customContext(mx::GlslShaderGenerator::create());
+        customContext.registerSourceCodeSearchPath(searchPath);
+        customShaders.push_back(cache->getShader(customSurface->getName(), customSurface, customContext, uniformValues));
+        REQUIRE(customShaders.back());
+    }
+    REQUIRE(customShaders[0] != customShaders[1]);
+    REQUIRE(customShaders[0]->getSourceCode(mx::Stage::PIXEL).find("* 2.0") != std::string::npos);
+    REQUIRE(customShaders[1]->getSourceCode(mx::Stage::PIXEL).find("* 3.0") != std::string::npos);
+
+    cache->clear();
+    REQUIRE(cache->getShaderCount() == 0);
+}
+#endif
+
+#ifdef MATERIALX_BUILD_GEN_GLSL
+TEST_CASE("GenShader: Constant Folding", "[genshader]")
+{
+    mx::FileSearchPath searchPath = mx::getDefaultDataSearchPath();
+    mx::DocumentPtr doc = mx::createDocument();
+    mx::loadLibraries({ "libraries" }, searchPath, doc);
+
+    // scale = (0.25 + 0.5) * 2, applied to texture coordinates through
+    // identities and conditionals with constant selectors.
+    mx::NodeGraphPtr nodeGraph = doc->addNodeGraph("NG_fold");
+    mx::NodePtr add = nodeGraph->addNode("add", "add1", "float");
+    add->setInputValue("in1", 0.25f);
+    add->setInputValue("in2", 0.5f);
+    mx::NodePtr scale = nodeGraph->addNode("multiply", "scale", "float");
+    scale->setConnectedNode("in1", add);
+    scale->setInputValue("in2", 2.0f);
+    mx::NodePtr texcoord = nodeGraph->addNode("texcoord", "texcoord1", "vector2");
+    mx::NodePtr multiply = nodeGraph->addNode("multiply", "multiply1", "vector2");
+    multiply->setConnectedNode("in1", texcoord);
+    multiply->setConnectedNode("in2", scale);
+    mx::NodePtr identity = nodeGraph->addNode("multiply", "identity1", "vector2");
+    identity->setConnectedNode("in1", multiply);
+    identity->setInputValue("in2", mx::Vector2(1.0f, 1.0f));
+    mx::NodePtr switchNode = nodeGraph->addNode("switch", "switch1", "vector2");
+    switchNode->setInputValue("in1", mx::Vector2(0.0f, 0.0f));
+    switchNode->setConnectedNode("in2", identity);
+    switchNode->setInputValue("which", 1.0f);
+    mx::NodePtr ifNode = nodeGraph->addNode("ifgreater", "ifgreater1", "vector2");
+    ifNode->setInputValue("value1", 1.0f);
+    ifNode->setInputValue("value2", 0.0f);
+    ifNode->setConnectedNode("in1", switchNode);
+    ifNode->setInputValue("in2", mx::Vector2(0.0f, 0.0f));
+    mx::OutputPtr output = nodeGraph->addOutput("out", "vector2");
+    output->setConnectedNode(ifNode);
+    REQUIRE(doc->validate());
+
+    mx::GenContext context(mx::GlslShaderGenerator::create());
+    context.registerSourceCodeSearchPath(searchPath);
+
+    // With a reduced interface the graph folds down to a single multiply.
+    context.getOptions().shaderInterfaceType = mx::SHADER_INTERFACE_REDUCED;
+    mx::ShaderGraphPtr graph = mx::ShaderGraph::create(nullptr, "fold", output, context);
+    REQUIRE(!graph->getNode("add1"));
+    REQUIRE(!graph->getNode("scale"));
+    REQUIRE(!graph->getNode("identity1"));
+    REQUIRE(!graph->getNode("switch1"));
+    REQUIRE(!graph->getNode("ifgreater1"));
+    mx::ShaderNode* multiplyNode = graph->getNode("multiply1");
+    REQUIRE(multiplyNode);
+    REQUIRE(graph->getOutputSocket()->getConnection() == multiplyNode->getOutput());
+    mx::ShaderInput* scaleInput = multiplyNode->getInput("in2");
+    REQUIRE(!scaleInput->getConnection());
+    REQUIRE(scaleInput->getValue()->asA<float>() == 1.5f);
+
+    // With a complete interface all inputs remain editable.
+    context.getOptions().shaderInterfaceType = mx::SHADER_INTERFACE_COMPLETE;
+    graph = mx::ShaderGraph::create(nullptr, "nofold", output, context);
+    REQUIRE(graph->getNode("add1"));
+    REQUIRE(graph->getNode("scale"));
+    REQUIRE(graph->getNode("switch1"));
+
+    // Folding input values also with a complete interface removes the
+    // folded nodes and their uniforms from the generated shader.
+    context.getOptions().foldInputValues = true;
+    graph = mx::ShaderGraph::create(nullptr, "fold_complete", output, context);
+    REQUIRE(!graph->getNode("add1"));
+    REQUIRE(!graph->getNode("scale"));
+    REQUIRE(graph->getNode("multiply1"));
+    mx::ShaderPtr shader = context.getShaderGenerator().generate("fold_complete", output, context);
+    const std::string& pixelSource = shader->getSourceCode(mx::Stage::PIXEL);
+    REQUIRE(pixelSource.find("add1_") == std::string::npos);
+    REQUIRE(pixelSource.find("scale_") == std::string::npos);
+    REQUIRE(pixelSource.find("multiply1_in2") != std::string::npos);
+    context.getOptions().foldInputValues = false;
+
+    // A selector beyond the last branch keeps the switch node.
+    context.getOptions().shaderInterfaceType = mx::SHADER_INTERFACE_REDUCED;
+    switchNode->setInputValue("which", 7.0f);
+    graph = mx::ShaderGraph::create(nullptr, "default", output, context);
+    REQUIRE(graph->getNode("switch1"));
+}
+#endif
+
+#ifdef MATERIALX_BUILD_GEN_GLSL
+TEST_CASE("GenShader: Common Subexpressions", "[genshader]")
+{
+    mx::FileSearchPath searchPath = mx::getDefaultDataSearchPath();
+    mx::DocumentPtr doc = mx::createDocument();
+    mx::loadLibraries({ "libraries" }, searchPath, doc);
+
+    // Two identical texture lookups on identical texture coordinates.
+    mx::NodeGraphPtr nodeGraph = doc->addNodeGraph("NG_cse");
+    std::vector<mx::NodePtr> images;
+    for (int i = 1; i <= 2; i++)
+    {
+        mx::NodePtr texcoord = nodeGraph->addNode("texcoord", "texcoord" + std::to_string(i), "vector2");
+        mx::NodePtr image = nodeGraph->addNode("image", "image" + std::to_string(i), "color3");
+        image->setInputValue("file", std::string("resources/Images/grid.png"), mx::FILENAME_TYPE_STRING);
+        image->setConnectedNode("texcoord", texcoord);
+        images.push_back(image);
+    }
+    mx::NodePtr add = nodeGraph->addNode("add", "add1", "color3");
+    add->setConnectedNode("in1", images[0]);
+    add->setConnectedNode("in2", images[1]);
+    mx::OutputPtr output = nodeGraph->addOutput("out", "color3");
+    output->setConnectedNode(add);
+    REQUIRE(doc->validate());
+
+    mx::GenContext context(mx::GlslShaderGenerator::create());
+    context.registerSourceCodeSearchPath(searchPath);
+
+    // With a reduced interface the duplicates are merged.
+    context.getOptions().shaderInterfaceType = mx::SHADER_INTERFACE_REDUCED;
+    mx::ShaderGraphPtr graph = mx::ShaderGraph::create(nullptr, "cse", output, context);
+    REQUIRE(graph->getNode("texcoord1"));
+    REQUIRE(!graph->getNode("texcoord2"));
+    REQUIRE(graph->getNode("image1"));
+    REQUIRE(!graph->getNode("image2"));
+    mx::ShaderNode* addNode = graph->getNode("add1");
+    REQUIRE(addNode->getInput("in1")->getConnection() == graph->getNode("image1")->getOutput());
+    REQUIRE(addNode->getInput("in2")->getConnection() == graph->getNode("image1")->getOutput());
+
+    // Nodes differing in an input value are kept apart.
+    images[1]->setInputValue("file", std::string("resources/Images/cloth.png"), mx::FILENAME_TYPE_STRING);
+    graph = mx::ShaderGraph::create(nullptr, "values", output, context);
+    REQUIRE(!graph->getNode("texcoord2"));
+    REQUIRE(graph->getNode("image1"));
+    REQUIRE(graph->getNode("image2"));
+
+    // With a complete interface nodes with editable inputs are kept apart.
+    images[1]->setInputValue("file", std::string("resources/Images/grid.png"), mx::FILENAME_TYPE_STRING);
+    context.getOptions().shaderInterfaceType = mx::SHADER_INTERFACE_COMPLETE;
+    graph = mx::ShaderGraph::create(nullptr, "complete", output, context);
+    REQUIRE(graph->getNode("image1"));
+    REQUIRE(graph->getNode("image2"));
+
+    // Folding input values merges them on their values again.
+    context.getOptions().foldInputValues = true;
+    graph = mx::ShaderGraph::create(nullptr, "complete_fold", output, context);
+    REQUIRE(graph->getNode("image1"));
+    REQUIRE(!graph->getNode("image2"));
+    addNode = graph->getNode("add1");
+    REQUIRE(addNode->getInput("in2")->getConnection() == graph->getNode("image1")->getOutput());
+    mx::ShaderPtr shader = context.getShaderGenerator().generate("complete_fold", output, context);
+    REQUIRE(shader->getSourceCode(mx::Stage::PIXEL).find("image2_") == std::string::npos);
+}
+#endif
@@ -18,6 +18,12 @@ void bindPyDocument(py::module& mod)
         .def("initialize", &mx::Document::initialize)
         .def("copy", &mx::Document::copy)
         .def("importLibrary", &mx::Document::importLibrary)
+        .def("setDataLibrary", &mx::Document::setDataLibrary)
+        .def("hasDataLibrary", &mx::Document::hasDataLibrary)
+        .def("getDataLibrary", &mx::Document::getDataLibrary)
+        .def("materializeDataLibraryElement", &mx::Document::materializeDataLibraryElement)
+        .def("setReadOnly", &mx::Document::setReadOnly)
+        .def("isReadOnly", &mx::Document::isReadOnly)
         .def("getReferencedSourceUris", &mx::Document::getReferencedSourceUris)
         .def("addNodeGraph", &mx::Document::addNodeGraph,
             py::arg("name") = mx::EMPTY_STRING)
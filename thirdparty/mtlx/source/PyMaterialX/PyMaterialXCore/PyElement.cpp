@@ -69,9 +69,9 @@ void bindPyElement(py::module& mod)
         .def("setChildIndex", &mx::Element::setChildIndex)
         .def("getChildIndex", &mx::Element::getChildIndex)
         .def("removeChild", &mx::Element::removeChild)
-        .def("setAttribute", &mx::Element::setAttribute)
-        .def("hasAttribute", &mx::Element::hasAttribute)
-        .def("getAttribute", &mx::Element::getAttribute)
+        .def("setAttribute", static_cast<void (mx::Element::*)(const std::string&, std::string)>(&mx::Element::setAttribute))
+        .def("hasAttribute", static_cast<bool (mx::Element::*)(const std::string&) const>(&mx::Element::hasAttribute))
+        .def("getAttribute", static_cast<const std::string& (mx::Element::*)(const std::string&) const>(&mx::Element::getAttribute))
         .def("getAttributeNames", &mx::Element::getAttributeNames)
         .def("removeAttribute", &mx::Element::removeAttribute)
         .def("getSelf", static_cast<mx::ElementPtr (mx::Element::*)()>(&mx::Element::getSelf))
@@ -212,6 +212,7 @@ void bindPyElement(py::module& mod)
     py::class_<mx::ElementPredicate>(mod, "ElementPredicate");
 
     py::register_exception<mx::ExceptionOrphanedElement>(mod, "ExceptionOrphanedElement");
+    py::register_exception<mx::ExceptionReadOnlyDocument>(mod, "ExceptionReadOnlyDocument");
 
     mod.def("targetStringsMatch", &mx::targetStringsMatch);
     mod.def("prettyPrint", &mx::prettyPrint);
@@ -8,6 +8,7 @@
 namespace py = pybind11;
 
 void bindPyFile(py::module& mod);
+void bindPyBinaryIo(py::module& mod);
 void bindPyXmlIo(py::module& mod);
 void bindPyUtil(py::module& mod);
 
@@ -20,5 +21,6 @@ PYBIND11_MODULE(PyMaterialXFormat, mod)
 
     bindPyFile(mod);
     bindPyXmlIo(mod);
+    bindPyBinaryIo(mod);
     bindPyUtil(mod);
 }
@@ -25,6 +25,7 @@ void bindPyGenOptions(py::module& mod)
 
     py::class_<mx::GenOptions>(mod, "GenOptions")
         .def_readwrite("shaderInterfaceType", &mx::GenOptions::shaderInterfaceType)
+        .def_readwrite("foldInputValues", &mx::GenOptions::foldInputValues)
         .def_readwrite("fileTextureVerticalFlip", &mx::GenOptions::fileTextureVerticalFlip)
         .def_readwrite("targetColorSpaceOverride", &mx::GenOptions::targetColorSpaceOverride)
         .def_readwrite("addUpstreamDependencies", &mx::GenOptions::addUpstreamDependencies)